@@ -0,0 +1,674 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bignum.h"
+
+// Size of the smaller operand, in limbs, where each algorithm starts to beat
+// the one before it. Measured with fib.exe --tune.
+#define KARATSUBA_THRESHOLD 32
+#define TOOM3_THRESHOLD 300
+#define NTT_THRESHOLD 2500
+// Products at least this many limbs long work each NTT prime out on its own
+// thread
+#define NTT_THREADS_THRESHOLD 16384
+
+// Primes of the form k*2^m + 1 with 3 as a primitive root, so each has the
+// roots of unity for transforms up to 2^23 long. Coefficients are worked out
+// modulo each and put back together, which is exact as long as they stay
+// below the primes' product, about 7.9e25: with under 2^23 limbs each is
+// below 2^22 * BIGNUM_BASE^2.
+static const uint32_t NTT_PRIMES[3] = {
+    998244353u,     // 119*2^23 + 1
+    469762049u,     // 7*2^26 + 1
+    167772161u,     // 5*2^25 + 1
+};
+#define NTT_GENERATOR 3
+#define NTT_MAX_SIZE (1 << 23)
+
+static int trimLimbs(const uint32_t *limbs, int size) {
+    while (size > 0 && limbs[size - 1] == 0) size--;
+    return size;
+}
+
+// out = a + b over aSize limbs (aSize >= bSize), returning the carry.
+// out may be a or b.
+static uint32_t addLimbs(uint32_t *out, const uint32_t *a, int aSize,
+                         const uint32_t *b, int bSize) {
+    uint32_t carry = 0;
+    for (int i = 0; i < aSize; i++) {
+        const uint32_t sum = a[i] + (i < bSize ? b[i] : 0) + carry;
+        carry = sum >= BIGNUM_BASE;
+        out[i] = carry ? sum - BIGNUM_BASE : sum;
+    }
+    return carry;
+}
+
+// out = a - b over aSize limbs, where a >= b. out may be a or b.
+static void subtractLimbs(uint32_t *out, const uint32_t *a, int aSize,
+                          const uint32_t *b, int bSize) {
+    uint32_t borrow = 0;
+    for (int i = 0; i < aSize; i++) {
+        const uint32_t taken = (i < bSize ? b[i] : 0) + borrow;
+        borrow = a[i] < taken;
+        out[i] = borrow ? a[i] + BIGNUM_BASE - taken : a[i] - taken;
+    }
+}
+
+// Sizes must be trimmed
+static int compareLimbs(const uint32_t *a, int aSize,
+                        const uint32_t *b, int bSize) {
+    if (aSize != bSize) return aSize < bSize ? -1 : 1;
+    for (int i = aSize - 1; i >= 0; i--) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// out (aSize + bSize limbs) = a * b
+static void multiplySchoolbook(uint32_t *out, const uint32_t *a, int aSize,
+                               const uint32_t *b, int bSize) {
+    memset(out, 0, sizeof(uint32_t) * (aSize + bSize));
+    for (int i = 0; i < bSize; i++) {
+        const uint64_t digit = b[i];
+        uint64_t carry = 0;
+        for (int j = 0; j < aSize; j++) {
+            const uint64_t product = digit * a[j] + out[i + j] + carry;
+            out[i + j] = (uint32_t)(product % BIGNUM_BASE);
+            carry = product / BIGNUM_BASE;
+        }
+        out[i + aSize] = (uint32_t)carry;
+    }
+}
+
+static bool multiplyLimbs(uint32_t *out, const uint32_t *a, int aSize,
+                          const uint32_t *b, int bSize,
+                          BigNumAlgorithm algorithm);
+
+// Lopsided: multiply b by one b sized slice of a at a time. Nothing has
+// been added past a slice's product yet, so its carry stops there.
+static bool multiplySlices(uint32_t *out, const uint32_t *a, int aSize,
+                           const uint32_t *b, int bSize) {
+    uint32_t *product = malloc(sizeof(uint32_t) * 2 * bSize);
+    if (product == NULL) return false;
+    memset(out, 0, sizeof(uint32_t) * (aSize + bSize));
+    for (int start = 0; start < aSize; start += bSize) {
+        const int sliceSize = aSize - start < bSize ? aSize - start : bSize;
+        if (!multiplyLimbs(product, a + start, sliceSize, b, bSize,
+                           BIGNUM_AUTO)) {
+            free(product);
+            return false;
+        }
+        addLimbs(out + start, out + start, sliceSize + bSize,
+                 product, sliceSize + bSize);
+    }
+    free(product);
+    return true;
+}
+
+// Karatsuba: with a = a1*B^half + a0 and b likewise,
+// a*b = z2*B^2half + (z1 - z2 - z0)*B^half + z0, where z0 = a0*b0,
+// z2 = a1*b1 and z1 = (a0 + a1)*(b0 + b1). bSize must be at least half.
+static bool multiplyKaratsuba(uint32_t *out, const uint32_t *a, int aSize,
+                              const uint32_t *b, int bSize) {
+    const int half = (aSize + 1) / 2;
+    const int a1Size = aSize - half;
+    const int b1Size = bSize - half;
+    uint32_t *scratch = malloc(sizeof(uint32_t) * (4 * half + 4));
+    if (scratch == NULL) return false;
+    uint32_t *aSum = scratch;
+    uint32_t *bSum = scratch + half + 1;
+    uint32_t *middle = scratch + 2 * half + 2;
+
+    aSum[half] = addLimbs(aSum, a, half, a + half, a1Size);
+    bSum[half] = addLimbs(bSum, b, half, b + half, b1Size);
+    const int aSumSize = trimLimbs(aSum, half + 1);
+    const int bSumSize = trimLimbs(bSum, half + 1);
+
+    // z0 and z2 go straight into the two halves of out
+    bool isOk = multiplyLimbs(out, a, half, b, half, BIGNUM_AUTO)
+        && multiplyLimbs(out + 2 * half, a + half, a1Size, b + half, b1Size,
+                         BIGNUM_AUTO)
+        && multiplyLimbs(middle, aSum, aSumSize, bSum, bSumSize, BIGNUM_AUTO);
+    if (isOk) {
+        const int middleSize = aSumSize + bSumSize;
+        subtractLimbs(middle, middle, middleSize,
+                      out, trimLimbs(out, 2 * half));
+        subtractLimbs(middle, middle, middleSize, out + 2 * half,
+                      trimLimbs(out + 2 * half, a1Size + b1Size));
+        addLimbs(out + half, out + half, aSize + bSize - half,
+                 middle, trimLimbs(middle, middleSize));
+    }
+
+    free(scratch);
+    return isOk;
+}
+
+// Toom-3 evaluates and interpolates through negative numbers on the way
+typedef struct SignedLimbs {
+    uint32_t *limbs;
+    int size;           // Trimmed
+    bool isNegative;
+} SignedLimbs;
+
+// limbs as a SignedLimbs, only ever read from
+static SignedLimbs viewLimbs(const uint32_t *limbs, int size) {
+    return (SignedLimbs){(uint32_t *)limbs, trimLimbs(limbs, size), false};
+}
+
+// out = a + b, or a - b if isSubtract. out's limbs need room for one more
+// than the longer input's, and may be a's or b's.
+static void addSigned(SignedLimbs *out, SignedLimbs a, SignedLimbs b,
+                      bool isSubtract) {
+    if (isSubtract) b.isNegative = !b.isNegative;
+    SignedLimbs swap;
+    if (a.isNegative == b.isNegative) {
+        if (a.size < b.size) {
+            swap = a; a = b; b = swap;
+        }
+        out->limbs[a.size] =
+            addLimbs(out->limbs, a.limbs, a.size, b.limbs, b.size);
+        out->size = a.size + 1;
+    } else {
+        if (compareLimbs(a.limbs, a.size, b.limbs, b.size) < 0) {
+            swap = a; a = b; b = swap;
+        }
+        subtractLimbs(out->limbs, a.limbs, a.size, b.limbs, b.size);
+        out->size = a.size;
+    }
+    out->size = trimLimbs(out->limbs, out->size);
+    out->isNegative = a.isNegative && out->size > 0;
+}
+
+// n /= divisor, which must divide it exactly
+static void divideSigned(SignedLimbs *n, uint32_t divisor) {
+    uint64_t remainder = 0;
+    for (int i = n->size - 1; i >= 0; i--) {
+        const uint64_t value = remainder * BIGNUM_BASE + n->limbs[i];
+        n->limbs[i] = (uint32_t)(value / divisor);
+        remainder = value % divisor;
+    }
+    n->size = trimLimbs(n->limbs, n->size);
+}
+
+// out = a * b, where out's limbs have room for both sizes together
+static bool multiplySigned(SignedLimbs *out, SignedLimbs a, SignedLimbs b) {
+    if (!multiplyLimbs(out->limbs, a.limbs, a.size, b.limbs, b.size,
+                       BIGNUM_AUTO)) return false;
+    out->size = trimLimbs(out->limbs, a.size + b.size);
+    out->isNegative = a.isNegative != b.isNegative && out->size > 0;
+    return true;
+}
+
+// p(1), p(-1) and p(-2) for p(x) = p2*x^2 + p1*x + p0
+static void evaluateToom3(SignedLimbs values[3], SignedLimbs p0,
+                          SignedLimbs p1, SignedLimbs p2) {
+    addSigned(&values[1], p0, p2, false);
+    addSigned(&values[0], values[1], p1, false);
+    addSigned(&values[1], values[1], p1, true);
+    // p(-2) = 2(p(-1) + p2) - p0
+    addSigned(&values[2], values[1], p2, false);
+    addSigned(&values[2], values[2], values[2], false);
+    addSigned(&values[2], values[2], p0, true);
+}
+
+// Toom-3: a and b split into thirds as polynomials in B^third, whose product
+// is found from its values at 0, 1, -1, -2 and infinity, so it takes five
+// multiplications a third long rather than nine. bSize must be over two
+// thirds.
+static bool multiplyToom3(uint32_t *out, const uint32_t *a, int aSize,
+                          const uint32_t *b, int bSize) {
+    const int third = (aSize + 2) / 3;
+    const int topSize = aSize + bSize - 4 * third;
+
+    // Evaluations fit a third plus a limb, and their products twice that.
+    // Both get a spare limb or two for carries while adding.
+    const int valueSize = third + 2;
+    const int productSize = 2 * valueSize + 2;
+    uint32_t *scratch =
+        malloc(sizeof(uint32_t) * (6 * valueSize + 3 * productSize));
+    if (scratch == NULL) return false;
+    SignedLimbs aValues[3], bValues[3], products[3];
+    for (int i = 0; i < 3; i++) {
+        aValues[i].limbs = scratch + i * valueSize;
+        bValues[i].limbs = scratch + (3 + i) * valueSize;
+        products[i].limbs = scratch + 6 * valueSize + i * productSize;
+    }
+
+    evaluateToom3(aValues, viewLimbs(a, third), viewLimbs(a + third, third),
+                  viewLimbs(a + 2 * third, aSize - 2 * third));
+    evaluateToom3(bValues, viewLimbs(b, third), viewLimbs(b + third, third),
+                  viewLimbs(b + 2 * third, bSize - 2 * third));
+
+    // r(0) and r(infinity) go straight into the bottom and top of out
+    bool isOk = multiplyLimbs(out, a, third, b, third, BIGNUM_AUTO)
+        && multiplyLimbs(out + 4 * third, a + 2 * third, aSize - 2 * third,
+                         b + 2 * third, bSize - 2 * third, BIGNUM_AUTO);
+    for (int i = 0; i < 3 && isOk; i++) {
+        isOk = multiplySigned(&products[i], aValues[i], bValues[i]);
+    }
+
+    if (isOk) {
+        const SignedLimbs atZero = viewLimbs(out, 2 * third);
+        const SignedLimbs atInfinity = viewLimbs(out + 4 * third, topSize);
+        SignedLimbs *r1 = &products[0];
+        SignedLimbs *r2 = &products[1];
+        SignedLimbs *r3 = &products[2];
+
+        // Bodrato's interpolation, turning r(1), r(-1) and r(-2) into the
+        // coefficients of B^third, B^2third and B^3third
+        addSigned(r3, *r3, *r1, true);
+        divideSigned(r3, 3);
+        addSigned(r1, *r1, *r2, true);
+        divideSigned(r1, 2);
+        addSigned(r2, *r2, atZero, true);
+        addSigned(r3, *r2, *r3, true);
+        divideSigned(r3, 2);
+        addSigned(r3, *r3, atInfinity, false);
+        addSigned(r3, *r3, atInfinity, false);
+        addSigned(r2, *r2, *r1, false);
+        addSigned(r2, *r2, atInfinity, true);
+        addSigned(r1, *r1, *r3, true);
+
+        // The product's coefficients are never negative, so these only add
+        memset(out + 2 * third, 0, sizeof(uint32_t) * 2 * third);
+        for (int i = 0; i < 3; i++) {
+            const int start = (i + 1) * third;
+            addLimbs(out + start, out + start, aSize + bSize - start,
+                     products[i].limbs, products[i].size);
+        }
+    }
+
+    free(scratch);
+    return isOk;
+}
+
+// Multiplication modulo a prime in Montgomery form, x*2^32 mod prime, which
+// swaps the division by prime for multiplies and a shift
+typedef struct Montgomery {
+    uint32_t prime;
+    uint32_t negativeInverse;   // -1/prime mod 2^32
+    uint32_t rSquared;          // 2^64 mod prime
+} Montgomery;
+
+static Montgomery createMontgomery(uint32_t prime) {
+    // Newton's method doubles the correct bits of 1/prime each step
+    uint32_t inverse = prime;
+    for (int i = 0; i < 4; i++) inverse *= 2 - prime * inverse;
+    const uint64_t r = ((uint64_t)1 << 32) % prime;
+    return (Montgomery){prime, -inverse, (uint32_t)(r * r % prime)};
+}
+
+// a*b/2^32 mod prime, for a below 2^32 and b below prime (a prime under
+// 2^31 keeps the sum from overflowing)
+static inline uint32_t multiplyMontgomery(const Montgomery *m,
+                                          uint32_t a, uint32_t b) {
+    const uint64_t product = (uint64_t)a * b;
+    const uint32_t factor = (uint32_t)product * m->negativeInverse;
+    const uint32_t result =
+        (uint32_t)((product + (uint64_t)factor * m->prime) >> 32);
+    return result >= m->prime ? result - m->prime : result;
+}
+
+static uint32_t toMontgomery(const Montgomery *m, uint32_t value) {
+    return multiplyMontgomery(m, value, m->rSquared);
+}
+
+static uint32_t powerMontgomery(const Montgomery *m, uint32_t base,
+                                uint32_t exponent) {
+    uint32_t result = toMontgomery(m, 1);
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) result = multiplyMontgomery(m, result, base);
+        base = multiplyMontgomery(m, base, base);
+    }
+    return result;
+}
+
+static uint32_t addModulo(uint32_t a, uint32_t b, uint32_t prime) {
+    const uint32_t sum = a + b;
+    return sum >= prime ? sum - prime : sum;
+}
+
+static uint32_t subtractModulo(uint32_t a, uint32_t b, uint32_t prime) {
+    return a >= b ? a - b : a + prime - b;
+}
+
+// Decimation in frequency, leaving the transform in bit reversed order.
+// roots[half + j] is the jth power of the (2*half)th root of unity.
+static void transformForward(const Montgomery *m, uint32_t *values, int size,
+                             const uint32_t *roots) {
+    for (int half = size / 2; half >= 1; half /= 2) {
+        for (int start = 0; start < size; start += 2 * half) {
+            uint32_t *low = values + start;
+            uint32_t *high = low + half;
+            for (int j = 0; j < half; j++) {
+                const uint32_t u = low[j];
+                const uint32_t v = high[j];
+                low[j] = addModulo(u, v, m->prime);
+                high[j] = multiplyMontgomery(
+                    m, subtractModulo(u, v, m->prime), roots[half + j]);
+            }
+        }
+    }
+}
+
+// Decimation in time, for the same transform from bit reversed order back
+// to normal order
+static void transformBack(const Montgomery *m, uint32_t *values, int size,
+                          const uint32_t *roots) {
+    for (int half = 1; half < size; half *= 2) {
+        for (int start = 0; start < size; start += 2 * half) {
+            uint32_t *low = values + start;
+            uint32_t *high = low + half;
+            for (int j = 0; j < half; j++) {
+                const uint32_t u = low[j];
+                const uint32_t v = multiplyMontgomery(m, high[j],
+                                                      roots[half + j]);
+                low[j] = addModulo(u, v, m->prime);
+                high[j] = subtractModulo(u, v, m->prime);
+            }
+        }
+    }
+}
+
+// One prime's share of an NTT multiplication, which can run on its own thread
+typedef struct NttJob {
+    const uint32_t *a;
+    int aSize;
+    const uint32_t *b;      // Same as a when squaring, saving a transform
+    int bSize;
+    int size;               // Transform length, a power of two
+    uint32_t prime;
+    uint32_t *values;       // The product's limb convolution modulo prime
+    bool isOk;
+} NttJob;
+
+static void loadNttValues(const Montgomery *m, uint32_t *values, int size,
+                          const uint32_t *limbs, int limbsSize) {
+    for (int i = 0; i < limbsSize; i++) {
+        values[i] = toMontgomery(m, limbs[i]);
+    }
+    memset(values + limbsSize, 0, sizeof(uint32_t) * (size - limbsSize));
+}
+
+static void *runNttJob(void *data) {
+    NttJob *job = data;
+    const Montgomery m = createMontgomery(job->prime);
+    const int size = job->size;
+    const bool isSquare = job->a == job->b && job->aSize == job->bSize;
+    uint32_t *roots = malloc(sizeof(uint32_t) * size);
+    uint32_t *bValues = isSquare ? NULL : malloc(sizeof(uint32_t) * size);
+    job->isOk = roots != NULL && (isSquare || bValues != NULL);
+    if (!job->isOk) {
+        free(roots);
+        free(bValues);
+        return NULL;
+    }
+
+    const uint32_t one = toMontgomery(&m, 1);
+    const uint32_t generator = toMontgomery(&m, NTT_GENERATOR);
+    for (int half = 1; half < size; half *= 2) {
+        const uint32_t root =
+            powerMontgomery(&m, generator, (job->prime - 1) / (2 * half));
+        roots[half] = one;
+        for (int j = 1; j < half; j++) {
+            roots[half + j] = multiplyMontgomery(&m, roots[half + j - 1], root);
+        }
+    }
+
+    uint32_t *values = job->values;
+    loadNttValues(&m, values, size, job->a, job->aSize);
+    transformForward(&m, values, size, roots);
+    if (isSquare) {
+        for (int i = 0; i < size; i++) {
+            values[i] = multiplyMontgomery(&m, values[i], values[i]);
+        }
+    } else {
+        loadNttValues(&m, bValues, size, job->b, job->bSize);
+        transformForward(&m, bValues, size, roots);
+        for (int i = 0; i < size; i++) {
+            values[i] = multiplyMontgomery(&m, values[i], bValues[i]);
+        }
+    }
+
+    // The inverse is the same transform with the results from 1 on reversed,
+    // then divided by size. Multiplying by 1/size outside Montgomery form
+    // also takes the values out of it.
+    transformBack(&m, values, size, roots);
+    for (int i = 1, j = size - 1; i < j; i++, j--) {
+        const uint32_t swap = values[i];
+        values[i] = values[j];
+        values[j] = swap;
+    }
+    const uint32_t inverseSize =
+        job->prime - (job->prime - 1) / (uint32_t)size;
+    for (int i = 0; i < size; i++) {
+        values[i] = multiplyMontgomery(&m, values[i], inverseSize);
+    }
+
+    free(roots);
+    free(bValues);
+    return NULL;
+}
+
+static uint32_t powerModulo(uint64_t base, uint32_t exponent, uint32_t prime) {
+    uint64_t result = 1;
+    for (base %= prime; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) result = result * base % prime;
+        base = base * base % prime;
+    }
+    return (uint32_t)result;
+}
+
+// Number theoretic transform: the limbs' convolution through a transform
+// modulo each of NTT_PRIMES, then put back together with the CRT while
+// carrying. aSize + bSize - 1 must be at most NTT_MAX_SIZE.
+static bool multiplyNtt(uint32_t *out, const uint32_t *a, int aSize,
+                        const uint32_t *b, int bSize) {
+    const int coefficientsSize = aSize + bSize - 1;
+    int size = 1;
+    while (size < coefficientsSize) size *= 2;
+    uint32_t *values = malloc(sizeof(uint32_t) * 3 * size);
+    if (values == NULL) return false;
+
+    NttJob jobs[3];
+    for (int i = 0; i < 3; i++) {
+        jobs[i] = (NttJob){a, aSize, b, bSize, size, NTT_PRIMES[i],
+                           values + i * size, false};
+    }
+    pthread_t threads[2];
+    bool isThreaded[2] = {false, false};
+    if (aSize + bSize >= NTT_THREADS_THRESHOLD) {
+        for (int i = 0; i < 2; i++) {
+            isThreaded[i] =
+                pthread_create(&threads[i], NULL, runNttJob, &jobs[i + 1]) == 0;
+        }
+    }
+    runNttJob(&jobs[0]);
+    for (int i = 0; i < 2; i++) {
+        if (isThreaded[i]) pthread_join(threads[i], NULL);
+        else runNttJob(&jobs[i + 1]);
+    }
+    if (!jobs[0].isOk || !jobs[1].isOk || !jobs[2].isOk) {
+        free(values);
+        return false;
+    }
+
+    // Garner's form of the CRT: x = r0 + p0*(t1 + p1*t2), with t1 and t2
+    // below p1 and p2. p0*p1 is split around BIGNUM_BASE so the carry fits
+    // 64 bits.
+    const uint64_t p0 = NTT_PRIMES[0];
+    const uint64_t p1 = NTT_PRIMES[1];
+    const uint64_t p2 = NTT_PRIMES[2];
+    const uint64_t p0InverseModP1 = powerModulo(p0, p1 - 2, p1);
+    const uint64_t p0InverseModP2 = powerModulo(p0, p2 - 2, p2);
+    const uint64_t p1InverseModP2 = powerModulo(p1, p2 - 2, p2);
+    const uint64_t p0p1Low = p0 * p1 % BIGNUM_BASE;
+    const uint64_t p0p1High = p0 * p1 / BIGNUM_BASE;
+    const uint32_t *r0s = values;
+    const uint32_t *r1s = values + size;
+    const uint32_t *r2s = values + 2 * size;
+    uint64_t carry = 0;
+    for (int i = 0; i < coefficientsSize; i++) {
+        const uint64_t r0 = r0s[i];
+        const uint64_t t1 = (r1s[i] + p1 - r0 % p1) * p0InverseModP1 % p1;
+        const uint64_t t2 =
+            ((r2s[i] + p2 - r0 % p2) * p0InverseModP2 % p2 + p2 - t1 % p2)
+            * p1InverseModP2 % p2;
+        const uint64_t low = r0 + t1 * p0 + t2 * p0p1Low + carry;
+        out[i] = (uint32_t)(low % BIGNUM_BASE);
+        carry = low / BIGNUM_BASE + t2 * p0p1High;
+    }
+    out[coefficientsSize] = (uint32_t)carry;
+
+    free(values);
+    return true;
+}
+
+// out (aSize + bSize limbs, not overlapping a or b) = a * b, with algorithm
+// for this level and BIGNUM_AUTO below it
+static bool multiplyLimbs(uint32_t *out, const uint32_t *a, int aSize,
+                          const uint32_t *b, int bSize,
+                          BigNumAlgorithm algorithm) {
+    if (aSize < bSize) {
+        const uint32_t *limbs = a;
+        a = b;
+        b = limbs;
+        const int size = aSize;
+        aSize = bSize;
+        bSize = size;
+    }
+    if (bSize == 0) {
+        memset(out, 0, sizeof(uint32_t) * aSize);
+        return true;
+    }
+
+    const bool canKaratsuba = bSize >= (aSize + 1) / 2;
+    const bool canToom3 = bSize > 2 * ((aSize + 2) / 3);
+    const bool canNtt = aSize + bSize - 1 <= NTT_MAX_SIZE;
+    if ((algorithm == BIGNUM_KARATSUBA && !canKaratsuba)
+        || (algorithm == BIGNUM_TOOM3 && !canToom3)
+        || (algorithm == BIGNUM_NTT && !canNtt)) algorithm = BIGNUM_AUTO;
+
+    if (algorithm == BIGNUM_AUTO) {
+        if (bSize < KARATSUBA_THRESHOLD) algorithm = BIGNUM_SCHOOLBOOK;
+        else if (bSize >= NTT_THRESHOLD && canNtt) algorithm = BIGNUM_NTT;
+        else if (aSize >= 2 * bSize) {
+            return multiplySlices(out, a, aSize, b, bSize);
+        }
+        else if (bSize >= TOOM3_THRESHOLD && canToom3) algorithm = BIGNUM_TOOM3;
+        else algorithm = BIGNUM_KARATSUBA;
+    }
+
+    switch (algorithm) {
+        case BIGNUM_KARATSUBA:
+            return multiplyKaratsuba(out, a, aSize, b, bSize);
+        case BIGNUM_TOOM3:
+            return multiplyToom3(out, a, aSize, b, bSize);
+        case BIGNUM_NTT:
+            return multiplyNtt(out, a, aSize, b, bSize);
+        default:
+            multiplySchoolbook(out, a, aSize, b, bSize);
+            return true;
+    }
+}
+
+static bool reserveBigNum(BigNum *n, int capacity) {
+    if (capacity <= n->capacity) return true;
+    uint32_t *limbs = realloc(n->limbs, sizeof(uint32_t) * capacity);
+    if (limbs == NULL) return false;
+    n->limbs = limbs;
+    n->capacity = capacity;
+    return true;
+}
+
+BigNum createBigNum(uint32_t value) {
+    BigNum n = {0};
+    if (value == 0 || !reserveBigNum(&n, 2)) return n;
+    n.limbs[0] = value % BIGNUM_BASE;
+    n.limbs[1] = value / BIGNUM_BASE;
+    n.size = trimLimbs(n.limbs, 2);
+    return n;
+}
+
+void unloadBigNum(BigNum *n) {
+    free(n->limbs);
+    *n = (BigNum){0};
+}
+
+bool addBigNums(BigNum *out, const BigNum *a, const BigNum *b) {
+    if (a->size < b->size) {
+        const BigNum *n = a;
+        a = b;
+        b = n;
+    }
+    // Reserving first, since out may be a or b
+    const int size = a->size;
+    if (!reserveBigNum(out, size + 1)) return false;
+    const uint32_t carry =
+        addLimbs(out->limbs, a->limbs, size, b->limbs, b->size);
+    out->limbs[size] = carry;
+    out->size = size + carry;
+    return true;
+}
+
+bool subtractBigNums(BigNum *out, const BigNum *a, const BigNum *b) {
+    const int size = a->size;
+    if (!reserveBigNum(out, size)) return false;
+    subtractLimbs(out->limbs, a->limbs, size, b->limbs, b->size);
+    out->size = trimLimbs(out->limbs, size);
+    return true;
+}
+
+bool multiplyBigNums(BigNum *out, const BigNum *a, const BigNum *b) {
+    return multiplyBigNumsWith(out, a, b, BIGNUM_AUTO);
+}
+
+bool multiplyBigNumsWith(BigNum *out, const BigNum *a, const BigNum *b,
+                         BigNumAlgorithm algorithm) {
+    if (a->size == 0 || b->size == 0) {
+        out->size = 0;
+        return true;
+    }
+
+    // A fresh buffer, since out may be a or b
+    const int size = a->size + b->size;
+    uint32_t *limbs = malloc(sizeof(uint32_t) * size);
+    if (limbs == NULL) return false;
+    if (!multiplyLimbs(limbs, a->limbs, a->size, b->limbs, b->size,
+                       algorithm)) {
+        free(limbs);
+        return false;
+    }
+
+    free(out->limbs);
+    out->limbs = limbs;
+    out->capacity = size;
+    out->size = trimLimbs(limbs, size);
+    return true;
+}
+
+int countBigNumDigits(const BigNum *n) {
+    if (n->size == 0) return 1;
+    int digits = (n->size - 1) * BIGNUM_BASE_DIGITS;
+    for (uint32_t top = n->limbs[n->size - 1]; top > 0; top /= 10) digits++;
+    return digits;
+}
+
+void formatBigNum(const BigNum *n, char *digits) {
+    if (n->size == 0) {
+        strcpy(digits, "0");
+        return;
+    }
+
+    int length = sprintf(digits, "%u", (unsigned int)n->limbs[n->size - 1]);
+    for (int i = n->size - 2; i >= 0; i--) {
+        uint32_t limb = n->limbs[i];
+        for (int j = BIGNUM_BASE_DIGITS - 1; j >= 0; j--) {
+            digits[length + j] = '0' + limb % 10;
+            limb /= 10;
+        }
+        length += BIGNUM_BASE_DIGITS;
+    }
+    digits[length] = '\0';
+}
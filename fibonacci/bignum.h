@@ -0,0 +1,50 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Base 10^9 so printing is just writing the limbs out, which matters more
+// here than the few percent a power of two base would save on maths
+#define BIGNUM_BASE 1000000000u
+#define BIGNUM_BASE_DIGITS 9
+
+// Non-negative arbitrary precision integer
+typedef struct BigNum {
+    uint32_t *limbs;    // Least significant first, each below BIGNUM_BASE
+    int size;           // Limbs in use, never with leading zeros (0 has none)
+    int capacity;
+} BigNum;
+
+BigNum createBigNum(uint32_t value);
+void unloadBigNum(BigNum *n);
+
+// out may be the same as either input. Return false if out of memory.
+bool addBigNums(BigNum *out, const BigNum *a, const BigNum *b);
+// a must be at least b
+bool subtractBigNums(BigNum *out, const BigNum *a, const BigNum *b);
+bool multiplyBigNums(BigNum *out, const BigNum *a, const BigNum *b);
+
+// Multiplication algorithms, each faster than the last on longer numbers
+typedef enum BigNumAlgorithm {
+    BIGNUM_AUTO,            // Pick by size, as multiplyBigNums does
+    BIGNUM_SCHOOLBOOK,
+    BIGNUM_KARATSUBA,
+    BIGNUM_TOOM3,
+    BIGNUM_NTT,             // Number theoretic transform, threaded when huge
+} BigNumAlgorithm;
+
+// multiplyBigNums with algorithm for the top level (the smaller products it
+// splits into still pick their own), for timing them against each other.
+// Falls back to BIGNUM_AUTO for sizes algorithm can't take: Karatsuba needs
+// the smaller number over half as long as the other, Toom-3 over two thirds,
+// and the NTT the two together under 2^23 limbs.
+bool multiplyBigNumsWith(BigNum *out, const BigNum *a, const BigNum *b,
+                         BigNumAlgorithm algorithm);
+
+int countBigNumDigits(const BigNum *n);
+// Decimal digits with no leading zeros into digits, which needs room for
+// countBigNumDigits + 1 chars
+void formatBigNum(const BigNum *n, char *digits);
+
+#endif // BIGNUM_H
@@ -1,19 +1,178 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bignum.h"
 
-int fib(int n) {
-    int prev2 = 0;
-    int prev1 = 1;
-    int result = 1;
+// Build with: gcc -O2 -pthread fib.c bignum.c -o fib.exe
+// Usage: fib.exe [n] [--summary] or fib.exe --tune
+// --summary prints the digit count, the ends of the number and the time
+// taken instead of every digit. --tune times each multiplication algorithm
+// for setting the thresholds in bignum.c.
 
-    for (int i = 0; i < n - 1; i++) {
-        result = prev1 + prev2;
-        prev2 = prev1;
-        prev1 = result;
+// Fast doubling, walking n's bits from the top:
+// F(2k) = F(k) * (2F(k+1) - F(k)) and F(2k+1) = F(k)^2 + F(k+1)^2
+bool fib(BigNum *result, unsigned long n) {
+    BigNum a = createBigNum(0);     // F(k)
+    BigNum b = createBigNum(1);     // F(k+1)
+    BigNum c = createBigNum(0);
+    BigNum d = createBigNum(0);
+
+    int topBit = -1;
+    for (unsigned long bits = n; bits > 0; bits >>= 1) topBit++;
+
+    bool isOk = true;
+    for (int i = topBit; i >= 0 && isOk; i--) {
+        // c = F(2k), d = F(2k+1), with a reused once F(k) isn't needed
+        isOk = addBigNums(&c, &b, &b)
+            && subtractBigNums(&c, &c, &a)
+            && multiplyBigNums(&c, &c, &a)
+            && multiplyBigNums(&d, &a, &a)
+            && multiplyBigNums(&a, &b, &b)
+            && addBigNums(&d, &d, &a);
+
+        BigNum swap;
+        if (n >> i & 1) {
+            // k becomes 2k + 1
+            swap = a; a = d; d = swap;
+            isOk = isOk && addBigNums(&b, &c, &a);
+        } else {
+            // k becomes 2k
+            swap = a; a = c; c = swap;
+            swap = b; b = d; d = swap;
+        }
+    }
+
+    unloadBigNum(&b);
+    unloadBigNum(&c);
+    unloadBigNum(&d);
+    if (!isOk) unloadBigNum(&a);
+    *result = a;
+    return isOk;
+}
+
+const char *getOrdinalSuffix(unsigned long n) {
+    if (n % 100 >= 11 && n % 100 <= 13) return "th";
+    switch (n % 10) {
+        case 1: return "st";
+        case 2: return "nd";
+        case 3: return "rd";
+        default: return "th";
     }
+}
+
+double getSeconds() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Random limbs, from the same xorshift everywhere so runs compare
+BigNum createRandomBigNum(int size, uint32_t *state) {
+    BigNum n = {malloc(sizeof(uint32_t) * size), size, size};
+    if (n.limbs == NULL) return (BigNum){0};
+    for (int i = 0; i < size; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 17;
+        *state ^= *state << 5;
+        n.limbs[i] = *state % BIGNUM_BASE;
+    }
+    if (n.limbs[size - 1] == 0) n.limbs[size - 1] = 1;
+    return n;
+}
 
-    return result;
+// Prints how long multiplying two numbers takes with each algorithm as they
+// grow, dropping algorithms once they take over a second. Each threshold
+// belongs around where the fastest column changes.
+void tune() {
+    const char *names[] = {"schoolbook", "karatsuba", "toom-3", "ntt"};
+    const int algorithmsSize = 4;
+    bool isTooSlow[4] = {false};
+    uint32_t state = 2463534242u;
+
+    printf("%9s", "limbs");
+    for (int i = 0; i < algorithmsSize; i++) printf(" %12s", names[i]);
+    printf("   fastest\n");
+    for (int size = 16; size <= 1 << 22; size = size * 3 / 2) {
+        BigNum a = createRandomBigNum(size, &state);
+        BigNum b = createRandomBigNum(size, &state);
+        BigNum product = createBigNum(0);
+        int fastest = -1;
+        double fastestTime = 0;
+
+        printf("%9d", size);
+        for (int i = 0; i < algorithmsSize; i++) {
+            if (isTooSlow[i] || a.limbs == NULL || b.limbs == NULL) {
+                printf(" %12s", "-");
+                continue;
+            }
+            // Repeated until it adds up to enough to time
+            int repetitions = 0;
+            const double start = getSeconds();
+            double elapsed;
+            do {
+                multiplyBigNumsWith(&product, &a, &b, BIGNUM_SCHOOLBOOK + i);
+                repetitions++;
+                elapsed = getSeconds() - start;
+            } while (elapsed < 0.2);
+
+            const double time = elapsed / repetitions;
+            printf(" %9.3f ms", time * 1000);
+            if (fastest < 0 || time < fastestTime) {
+                fastest = i;
+                fastestTime = time;
+            }
+            isTooSlow[i] = time > 1;
+        }
+        printf("   %s\n", fastest < 0 ? "-" : names[fastest]);
+        fflush(stdout);
+
+        unloadBigNum(&a);
+        unloadBigNum(&b);
+        unloadBigNum(&product);
+    }
 }
 
-int main() {
-    printf("The 10th Fibonacci number is %d", fib(10));
+int main(int argc, char *argv[]) {
+    unsigned long n = 10;
+    bool isSummary = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--summary") == 0) isSummary = true;
+        else if (strcmp(argv[i], "--tune") == 0) {
+            tune();
+            return 0;
+        }
+        else n = strtoul(argv[i], NULL, 10);
+    }
+
+    const double start = getSeconds();
+    BigNum result;
+    if (!fib(&result, n)) {
+        fprintf(stderr, "Ran out of memory working out fib(%lu)\n", n);
+        return 1;
+    }
+    const double elapsed = getSeconds() - start;
+
+    const int digitsSize = countBigNumDigits(&result);
+    char *digits = malloc(digitsSize + 1);
+    if (digits == NULL) {
+        fprintf(stderr, "Ran out of memory printing fib(%lu)\n", n);
+        unloadBigNum(&result);
+        return 1;
+    }
+    formatBigNum(&result, digits);
+
+    if (isSummary && digitsSize > 40) {
+        printf("The %lu%s Fibonacci number has %d digits: %.20s...%s\n",
+               n, getOrdinalSuffix(n), digitsSize, digits,
+               digits + digitsSize - 20);
+    } else {
+        printf("The %lu%s Fibonacci number is %s\n",
+               n, getOrdinalSuffix(n), digits);
+    }
+    if (isSummary) printf("Worked out in %.3f ms\n", elapsed * 1000);
+
+    free(digits);
+    unloadBigNum(&result);
+    return 0;
 }
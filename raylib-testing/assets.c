@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assets.h"
+#include "platform.h"
+
+static const char ASSET_CACHE_MAGIC[4] = {'R', 'G', 'B', 'A'};
+
+// FNV-1a over a file's bytes. Returns 0 if the file can't be read.
+static uint64_t hashFile(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return 0;
+
+    uint64_t hash = 14695981039346656037ull;
+    unsigned char buffer[16384];
+    size_t bytesRead;
+    while ((bytesRead = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        for (size_t i = 0; i < bytesRead; i++)
+        {
+            hash ^= buffer[i];
+            hash *= 1099511628211ull;
+        }
+
+    fclose(file);
+    return hash;
+}
+
+void getAssetCachePath(const char *fileName, int width, int height,
+                       char *path, int pathSize)
+{
+    snprintf(path, pathSize, "%s.%dx%d.cache", fileName, width, height);
+}
+
+bool bakeAssetCache(const char *fileName, int width, int height)
+{
+    Image image = LoadImage(fileName);
+    if (image.data == NULL) return false;
+    if (width > 0 && height > 0) ImageResize(&image, width, height);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    AssetCacheHeader header = {
+        .version = ASSET_CACHE_VERSION,
+        .width = image.width,
+        .height = image.height,
+        .sourceHash = hashFile(fileName),
+        .pixelsSize = (uint64_t)image.width * image.height * 4,
+    };
+    memcpy(header.magic, ASSET_CACHE_MAGIC, sizeof(header.magic));
+
+    char path[ASSET_FILE_NAME_SIZE + 32];
+    getAssetCachePath(fileName, width, height, path, sizeof(path));
+    FILE *file = fopen(path, "wb");
+    bool isOk = file != NULL
+        && fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(image.data, 1, header.pixelsSize, file) == header.pixelsSize;
+    if (file != NULL && fclose(file) != 0) isOk = false;
+
+    UnloadImage(image);
+    return isOk;
+}
+
+// Points request->image at its mapped cache if there's one that matches
+// the request and the source file it was baked from. A cache without its
+// source file is trusted, so caches can ship on their own.
+static bool loadAssetCache(AssetRequest *request)
+{
+    char path[ASSET_FILE_NAME_SIZE + 32];
+    getAssetCachePath(request->fileName, request->width, request->height,
+                      path, sizeof(path));
+
+    size_t size;
+    const unsigned char *data = mapFile(path, &size);
+    if (data == NULL) return false;
+
+    const AssetCacheHeader *header = (const AssetCacheHeader *)data;
+    const uint64_t sourceHash = hashFile(request->fileName);
+    const bool isValid = size >= sizeof(AssetCacheHeader)
+        && memcmp(header->magic, ASSET_CACHE_MAGIC, sizeof(header->magic)) == 0
+        && header->version == ASSET_CACHE_VERSION
+        && (request->width <= 0 || (int)header->width == request->width)
+        && (request->height <= 0 || (int)header->height == request->height)
+        && header->pixelsSize == (uint64_t)header->width * header->height * 4
+        && size - sizeof(AssetCacheHeader) >= header->pixelsSize
+        && (sourceHash == 0 || sourceHash == header->sourceHash);
+    if (!isValid)
+    {
+        unmapFile(data, size);
+        return false;
+    }
+
+    request->mapping = data;
+    request->mappingSize = size;
+    request->image = (Image){
+        .data = (void *)(data + sizeof(AssetCacheHeader)),
+        .width = header->width,
+        .height = header->height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+    };
+    return true;
+}
+
+// Frees a decoded image however it was loaded
+static void releaseAssetImage(AssetRequest *request)
+{
+    if (request->mapping != NULL)
+        unmapFile(request->mapping, request->mappingSize);
+    else
+        UnloadImage(request->image);
+    request->image = (Image){0};
+    request->mapping = NULL;
+    request->mappingSize = 0;
+}
+
+// Returns the next pending request (marked as decoding), or -1 when the
+// loader is stopping. Called with the mutex held.
+static int takeAssetRequest(AssetLoader *loader)
+{
+    while (!loader->isStopping)
+    {
+        for (int i = 0; i < loader->requestsSize; i++)
+            if (loader->requests[i].status == ASSET_PENDING)
+            {
+                loader->requests[i].status = ASSET_DECODING;
+                return i;
+            }
+        pthread_cond_wait(&loader->workReady, &loader->mutex);
+    }
+    return -1;
+}
+
+static void *runAssetWorker(void *argument)
+{
+    AssetLoader *loader = argument;
+
+    pthread_mutex_lock(&loader->mutex);
+    int index;
+    while ((index = takeAssetRequest(loader)) >= 0)
+    {
+        // Requests never move, and nothing else touches one while it's
+        // decoding, so the slow part can run unlocked
+        AssetRequest *request = &loader->requests[index];
+        pthread_mutex_unlock(&loader->mutex);
+
+        // Stale or missing caches fall back to decoding the source
+        if (!loadAssetCache(request))
+        {
+            request->image = LoadImage(request->fileName);
+            if (request->image.data != NULL
+             && request->width > 0 && request->height > 0)
+                ImageResize(&request->image, request->width, request->height);
+        }
+
+        pthread_mutex_lock(&loader->mutex);
+        request->status = request->image.data != NULL
+            ? ASSET_DECODED : ASSET_FAILED;
+    }
+    pthread_mutex_unlock(&loader->mutex);
+
+    return NULL;
+}
+
+AssetLoader *createAssetLoader(int threadsSize)
+{
+    if (threadsSize <= 0) threadsSize = getProcessorCount() - 1;
+    if (threadsSize <= 0) threadsSize = 1;
+
+    AssetLoader *loader = calloc(1, sizeof(AssetLoader));
+    pthread_mutex_init(&loader->mutex, NULL);
+    pthread_cond_init(&loader->workReady, NULL);
+
+    loader->threadsSize = threadsSize;
+    loader->threads = calloc(threadsSize, sizeof(pthread_t));
+    for (int i = 0; i < threadsSize; i++)
+        pthread_create(&loader->threads[i], NULL, runAssetWorker, loader);
+
+    return loader;
+}
+
+void unloadAssetLoader(AssetLoader *loader)
+{
+    pthread_mutex_lock(&loader->mutex);
+    loader->isStopping = true;
+    pthread_cond_broadcast(&loader->workReady);
+    pthread_mutex_unlock(&loader->mutex);
+
+    for (int i = 0; i < loader->threadsSize; i++)
+        pthread_join(loader->threads[i], NULL);
+
+    for (int i = 0; i < loader->requestsSize; i++)
+        if (loader->requests[i].status == ASSET_DECODED)
+            releaseAssetImage(&loader->requests[i]);
+
+    pthread_mutex_destroy(&loader->mutex);
+    pthread_cond_destroy(&loader->workReady);
+    free(loader->threads);
+    free(loader);
+}
+
+int requestSpriteSheet(AssetLoader *loader, const char *fileName,
+                       int width, int height, int columns, int rows)
+{
+    pthread_mutex_lock(&loader->mutex);
+    int index = -1;
+    if (loader->requestsSize < ASSET_LOADER_MAX_REQUESTS)
+    {
+        index = loader->requestsSize++;
+        AssetRequest *request = &loader->requests[index];
+        *request = (AssetRequest){
+            .width = width,
+            .height = height,
+            .columns = columns,
+            .rows = rows,
+            .status = ASSET_PENDING,
+            .sheet = -1,
+        };
+        snprintf(request->fileName, ASSET_FILE_NAME_SIZE, "%s", fileName);
+        pthread_cond_signal(&loader->workReady);
+    }
+    pthread_mutex_unlock(&loader->mutex);
+
+    return index;
+}
+
+int uploadLoadedAssets(AssetLoader *loader, SpriteAtlas *atlas)
+{
+    int uploads[ASSET_LOADER_MAX_REQUESTS];
+    int uploadsSize = 0;
+
+    pthread_mutex_lock(&loader->mutex);
+    for (int i = 0; i < loader->requestsSize; i++)
+        if (loader->requests[i].status == ASSET_DECODED)
+        {
+            loader->requests[i].status = ASSET_UPLOADING;
+            uploads[uploadsSize++] = i;
+        }
+    pthread_mutex_unlock(&loader->mutex);
+
+    // Like decoding, nothing else touches a request while it's uploading,
+    // so workers can keep taking and finishing others meanwhile
+    for (int i = 0; i < uploadsSize; i++)
+    {
+        AssetRequest *request = &loader->requests[uploads[i]];
+        const int sheet = addSpriteSheet(atlas, request->image,
+                                         request->columns, request->rows);
+        releaseAssetImage(request);
+
+        pthread_mutex_lock(&loader->mutex);
+        request->sheet = sheet;
+        request->status = sheet >= 0 ? ASSET_READY : ASSET_FAILED;
+        pthread_mutex_unlock(&loader->mutex);
+    }
+
+    return uploadsSize;
+}
+
+int getAssetSheet(AssetLoader *loader, int request)
+{
+    if (request < 0) return -1;
+
+    pthread_mutex_lock(&loader->mutex);
+    const int sheet = loader->requests[request].sheet;
+    pthread_mutex_unlock(&loader->mutex);
+
+    return sheet;
+}
@@ -0,0 +1,92 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/raylib.h"
+#include "sprites.h"
+
+typedef enum AssetStatus
+{
+    ASSET_PENDING,            // Waiting for a worker
+    ASSET_DECODING,           // A worker is loading/resizing it
+    ASSET_DECODED,            // Waiting for the main thread to upload it
+    ASSET_UPLOADING,          // The main thread is putting it in the atlas
+    ASSET_READY,              // In the atlas, sheet is valid
+    ASSET_FAILED,
+} AssetStatus;
+
+#define ASSET_FILE_NAME_SIZE 256
+
+typedef struct AssetRequest
+{
+    char fileName[ASSET_FILE_NAME_SIZE];
+    int width;                // Resize to this, 0 keeps the file's size
+    int height;
+    int columns;
+    int rows;
+    AssetStatus status;
+    Image image;              // Set once decoded, freed once uploaded
+    const void *mapping;      // Cache file image.data points into, if any
+    size_t mappingSize;
+    int sheet;                // Atlas sheet once ready, -1 before
+} AssetRequest;
+
+#define ASSET_LOADER_MAX_REQUESTS 64
+
+// Start of a baked asset cache file. The final RGBA pixels (already
+// resized) follow straight after, so a mapped cache can be uploaded as is.
+typedef struct AssetCacheHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t sourceHash;      // FNV-1a of the source file the pixels came from
+    uint64_t pixelsSize;
+    uint8_t reserved[32];     // Pads the header to 64 bytes
+} AssetCacheHeader;
+
+#define ASSET_CACHE_VERSION 1
+
+// Decodes and resizes images on worker threads so the game can start
+// drawing straight away. Up to date baked caches are mapped instead of
+// decoding the PNG at all. Finished images wait for uploadLoadedAssets,
+// which runs on the main thread since it owns the GL context.
+typedef struct AssetLoader
+{
+    AssetRequest requests[ASSET_LOADER_MAX_REQUESTS];
+    int requestsSize;
+    pthread_t *threads;
+    int threadsSize;
+    pthread_mutex_t mutex;
+    pthread_cond_t workReady;
+    bool isStopping;
+} AssetLoader;
+
+// Where the baked cache for fileName at this size lives
+void getAssetCachePath(const char *fileName, int width, int height,
+                       char *path, int pathSize);
+// Decodes (and resizes) fileName and writes its cache. Doesn't need a
+// window, so it can run as an offline step.
+bool bakeAssetCache(const char *fileName, int width, int height);
+
+// threadsSize <= 0 leaves one processor for the main thread
+AssetLoader *createAssetLoader(int threadsSize);
+// Waits for workers to finish what they're on, then frees everything,
+// including decoded images that never got uploaded
+void unloadAssetLoader(AssetLoader *loader);
+
+// Queues a sprite sheet and returns a handle for getAssetSheet, or -1 if
+// the queue is full
+int requestSpriteSheet(AssetLoader *loader, const char *fileName,
+                       int width, int height, int columns, int rows);
+// Moves every decoded image into the atlas. Call once per frame from the
+// main thread. Returns how many were uploaded.
+int uploadLoadedAssets(AssetLoader *loader, SpriteAtlas *atlas);
+// The atlas sheet for a request, or -1 while it's still loading (or if it
+// failed), in which case draw a placeholder
+int getAssetSheet(AssetLoader *loader, int request);
+
+#endif // ASSETS_H
@@ -0,0 +1,118 @@
+#include <stdlib.h>
+#include "batch.h"
+#include "platform.h"
+
+static void runPhysicsChunk(const PhysicsJob *job, int chunk, int chunksSize)
+{
+    const int start = (long long)job->playersSize * chunk / chunksSize;
+    const int end = (long long)job->playersSize * (chunk + 1) / chunksSize;
+
+    for (int i = start; i < end; i++)
+    {
+        Player *player = &job->players[i];
+        const PlayerInput input = job->inputs[i];
+        bool hasReachedGoal = false;
+        for (int tick = 0; tick < job->ticks; tick++)
+            if (updatePlayer(player, input, job->level, PHYSICS_DELTA))
+                hasReachedGoal = true;
+        if (hasReachedGoal && job->goalsReached != NULL)
+            job->goalsReached[i] = true;
+    }
+}
+
+static void *runPhysicsWorker(void *argument)
+{
+    PhysicsWorker *worker = argument;
+    PhysicsPool *pool = worker->pool;
+    unsigned long long seenGeneration = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true)
+    {
+        while (!pool->isStopping && pool->generation == seenGeneration)
+            pthread_cond_wait(&pool->workReady, &pool->mutex);
+        if (pool->isStopping) break;
+
+        seenGeneration = pool->generation;
+        const PhysicsJob job = pool->job;
+        pthread_mutex_unlock(&pool->mutex);
+
+        runPhysicsChunk(&job, worker->index, pool->threadsSize);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pendingWorkers == 0)
+            pthread_cond_signal(&pool->workDone);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+PhysicsPool *createPhysicsPool(int threadsSize)
+{
+    if (threadsSize <= 0) threadsSize = getProcessorCount();
+
+    PhysicsPool *pool = calloc(1, sizeof(PhysicsPool));
+    pool->threadsSize = threadsSize;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->workReady, NULL);
+    pthread_cond_init(&pool->workDone, NULL);
+
+    // Worker 0 is whoever calls stepPlayers
+    pool->workers = calloc(threadsSize, sizeof(PhysicsWorker));
+    for (int i = 1; i < threadsSize; i++)
+    {
+        pool->workers[i] = (PhysicsWorker){.pool = pool, .index = i};
+        pthread_create(&pool->workers[i].thread, NULL,
+                       runPhysicsWorker, &pool->workers[i]);
+    }
+
+    return pool;
+}
+
+void unloadPhysicsPool(PhysicsPool *pool)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->isStopping = true;
+    pthread_cond_broadcast(&pool->workReady);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->threadsSize; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->workReady);
+    pthread_cond_destroy(&pool->workDone);
+    free(pool->workers);
+    free(pool);
+}
+
+void stepPlayers(PhysicsPool *pool,
+                 Player players[], const PlayerInput inputs[],
+                 bool goalsReached[], int playersSize,
+                 const Level *level, int ticks)
+{
+    const PhysicsJob job = {
+        players, inputs, goalsReached, playersSize, level, ticks
+    };
+
+    if (pool->threadsSize > 1)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pool->job = job;
+        pool->pendingWorkers = pool->threadsSize - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->workReady);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    runPhysicsChunk(&job, 0, pool->threadsSize);
+
+    if (pool->threadsSize > 1)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->pendingWorkers > 0)
+            pthread_cond_wait(&pool->workDone, &pool->mutex);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <pthread.h>
+#include "physics.h"
+
+// One call's worth of work for the pool: every player gets `ticks` steps
+// with its own input held the whole time
+typedef struct PhysicsJob
+{
+    Player *players;
+    const PlayerInput *inputs;
+    bool *goalsReached;       // Set (never cleared) when a player hits a goal
+    int playersSize;
+    const Level *level;       // Shared and read only
+    int ticks;
+} PhysicsJob;
+
+typedef struct PhysicsWorker
+{
+    struct PhysicsPool *pool;
+    int index;
+    pthread_t thread;
+} PhysicsWorker;
+
+// Threads that step players in parallel. The calling thread takes the
+// first chunk of every job, so a pool of N threads starts N - 1 workers.
+typedef struct PhysicsPool
+{
+    PhysicsWorker *workers;
+    int threadsSize;
+    pthread_mutex_t mutex;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    unsigned long long generation;
+    int pendingWorkers;
+    bool isStopping;
+    PhysicsJob job;
+} PhysicsPool;
+
+// threadsSize <= 0 uses one thread per logical processor
+PhysicsPool *createPhysicsPool(int threadsSize);
+void unloadPhysicsPool(PhysicsPool *pool);
+
+// Advances every player by ticks * PHYSICS_DELTA. Players are split into
+// one contiguous chunk per thread, and each player runs all its ticks
+// before the next one starts so it stays in cache. Blocks until done.
+void stepPlayers(PhysicsPool *pool,
+                 Player players[], const PlayerInput inputs[],
+                 bool goalsReached[], int playersSize,
+                 const Level *level, int ticks);
+
+#endif // BATCH_H
@@ -0,0 +1,720 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "physics.h"
+#include "platform.h"
+#include "scalarmath.h"
+#include "vectors.h"
+// Header only so every function gets inlined the way the game's code does
+#define RAYMATH_HEADER_ONLY
+#include "include/raymath.h"
+
+// Microbenchmarks for the game's hot functions. Each one is run for a
+// warmup, then timed over several repetitions; the spread between them
+// (percentiles, standard deviation) says how far to trust the median.
+//
+// Usage: benchmark.exe [--filter text] [--repetitions n] [--json file]
+//                      [--baseline file] [--tolerance percent]
+
+// Runs whatever is being measured opsSize times
+typedef void (*BenchmarkFunction)(void *context, long long opsSize);
+// Builds (or frees) a benchmark's inputs, outside of the timing
+typedef void (*BenchmarkSetupFunction)(void *context);
+
+typedef struct Benchmark
+{
+    char name[64];
+    BenchmarkFunction run;
+    BenchmarkSetupFunction setup;
+    BenchmarkSetupFunction teardown;
+    void *context;
+} Benchmark;
+
+// Every time is in nanoseconds per op
+typedef struct BenchmarkResult
+{
+    const char *name;
+    long long opsPerRepetition;
+    int repetitions;
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+    double mean;
+    double standardDeviation;
+} BenchmarkResult;
+
+typedef struct BenchmarkOptions
+{
+    const char *filter;       // Only names containing this run, if set
+    int repetitions;
+    double repetitionSeconds; // Roughly how long each repetition takes
+    double warmupSeconds;
+} BenchmarkOptions;
+
+#define BENCHMARKS_CAPACITY 64
+#define BENCHMARK_MAX_REPETITIONS 1000
+// Inputs cycle through this many values, small enough to stay in L1
+#define BENCHMARK_VALUES_SIZE 1024
+
+// Results get written here so the compiler can't drop the work
+static volatile float benchmarkSink;
+
+static Vector2 vector2Values[BENCHMARK_VALUES_SIZE];
+static Vector3 vector3Values[BENCHMARK_VALUES_SIZE];
+static Matrix matrixValues[BENCHMARK_VALUES_SIZE];
+static Rectangle rectangleValues[BENCHMARK_VALUES_SIZE];
+static Vector2 vector2Results[BENCHMARK_VALUES_SIZE];
+static Vector3 vector3Results[BENCHMARK_VALUES_SIZE];
+static Matrix matrixResults[BENCHMARK_VALUES_SIZE];
+
+// xorshift32 rather than rand(), whose range (32767 on Windows) and
+// sequence change between C libraries
+static unsigned int getBenchmarkRandom(unsigned int *seed)
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+static float getRandomFloat(unsigned int *seed, float min, float max)
+{
+    return min + (max - min) * (getBenchmarkRandom(seed) >> 8) / 16777216.0f;
+}
+
+// HARNESS
+
+static int compareDoubles(const void *a, const void *b)
+{
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank, on sorted samples
+static double getPercentile(const double samples[], int samplesSize,
+                            double percentile)
+{
+    int rank = (int)ceil(percentile / 100.0 * samplesSize) - 1;
+    if (rank < 0) rank = 0;
+    if (rank >= samplesSize) rank = samplesSize - 1;
+    return samples[rank];
+}
+
+static double timeBenchmark(const Benchmark *benchmark, long long opsSize)
+{
+    const double start = getWallTime();
+    benchmark->run(benchmark->context, opsSize);
+    return getWallTime() - start;
+}
+
+static BenchmarkResult runBenchmark(const Benchmark *benchmark,
+                                    BenchmarkOptions options)
+{
+    // Warm caches and branch predictors while doubling the op count until
+    // one run is long enough to time reliably
+    long long opsSize = 1;
+    double elapsed = timeBenchmark(benchmark, opsSize);
+    const double warmupStart = getWallTime();
+    while (elapsed < options.repetitionSeconds / 4
+           || getWallTime() - warmupStart < options.warmupSeconds)
+    {
+        if (elapsed < options.repetitionSeconds / 4) opsSize *= 2;
+        elapsed = timeBenchmark(benchmark, opsSize);
+    }
+    opsSize = (long long)(opsSize * options.repetitionSeconds / elapsed);
+    if (opsSize < 1) opsSize = 1;
+
+    static double samples[BENCHMARK_MAX_REPETITIONS];
+    double total = 0;
+    for (int i = 0; i < options.repetitions; i++)
+    {
+        samples[i] = timeBenchmark(benchmark, opsSize) * 1e9 / opsSize;
+        total += samples[i];
+    }
+    qsort(samples, options.repetitions, sizeof(double), compareDoubles);
+
+    const double mean = total / options.repetitions;
+    double variance = 0;
+    for (int i = 0; i < options.repetitions; i++)
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    variance /= options.repetitions > 1 ? options.repetitions - 1 : 1;
+
+    return (BenchmarkResult){
+        .name = benchmark->name,
+        .opsPerRepetition = opsSize,
+        .repetitions = options.repetitions,
+        .min = samples[0],
+        .median = getPercentile(samples, options.repetitions, 50),
+        .p90 = getPercentile(samples, options.repetitions, 90),
+        .p99 = getPercentile(samples, options.repetitions, 99),
+        .max = samples[options.repetitions - 1],
+        .mean = mean,
+        .standardDeviation = sqrt(variance),
+    };
+}
+
+static bool saveBenchmarkJson(const BenchmarkResult results[],
+                              int resultsSize, const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    // One benchmark per line, which is what findBaselineMedian expects
+    fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+    for (int i = 0; i < resultsSize; i++)
+    {
+        const BenchmarkResult *result = &results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"repetitions\": %d, "
+                "\"opsPerRepetition\": %lld, \"min\": %.4f, "
+                "\"median\": %.4f, \"p90\": %.4f, \"p99\": %.4f, "
+                "\"max\": %.4f, \"mean\": %.4f, \"stddev\": %.4f}%s\n",
+                result->name, result->repetitions, result->opsPerRepetition,
+                result->min, result->median, result->p90, result->p99,
+                result->max, result->mean, result->standardDeviation,
+                i + 1 < resultsSize ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    const bool isOk = !ferror(file);
+    return fclose(file) == 0 && isOk;
+}
+
+// Median of name in a file saveBenchmarkJson wrote, or -1 if it isn't there
+static double findBaselineMedian(FILE *file, const char *name)
+{
+    rewind(file);
+    char line[512];
+    char lineName[64];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        const char *nameStart = strstr(line, "\"name\": \"");
+        const char *median = strstr(line, "\"median\": ");
+        if (nameStart == NULL || median == NULL) continue;
+        if (sscanf(nameStart, "\"name\": \"%63[^\"]\"", lineName) != 1)
+            continue;
+        if (strcmp(lineName, name) != 0) continue;
+
+        double value;
+        if (sscanf(median, "\"median\": %lf", &value) == 1) return value;
+    }
+    return -1;
+}
+
+// BENCHMARKS
+
+typedef struct PlayerBenchmark
+{
+    int platformsSize;
+    Level level;
+    Player player;
+    long long tick;
+} PlayerBenchmark;
+
+// Platforms spread over a square that grows with their count, so the
+// density around the player (and so the narrowphase work) stays the same
+// and only the broadphase's scaling shows
+static void setupPlayerBenchmark(void *context)
+{
+    PlayerBenchmark *benchmark = context;
+    const int platformsSize = benchmark->platformsSize;
+    const int side = (int)(sqrt(platformsSize) * 400);
+
+    benchmark->level = createLevel(platformsSize + 1);
+    addLevelElement(&benchmark->level, (RectangleEnv){
+        {-side / 2 - 1000, 1000, side + 2000, 100}, GRAY, 1
+    });
+    unsigned int seed = 1;
+    for (int i = 0; i < platformsSize; i++)
+    {
+        const Rectangle rect = {
+            -side / 2 + (int)(getBenchmarkRandom(&seed) % side),
+            1000 - (int)(getBenchmarkRandom(&seed) % side),
+            20 + getBenchmarkRandom(&seed) % 200,
+            10 + getBenchmarkRandom(&seed) % 20
+        };
+        addLevelElement(&benchmark->level, (RectangleEnv){rect, GRAY, 1});
+    }
+    bakeLevel(&benchmark->level);
+
+    benchmark->player = getDefaultPlayer();
+    benchmark->tick = 0;
+}
+
+static void teardownPlayerBenchmark(void *context)
+{
+    PlayerBenchmark *benchmark = context;
+    unloadLevel(&benchmark->level);
+}
+
+// One op is one updatePlayer tick, running, jumping and boosting back and
+// forth, with a respawn now and then so it doesn't wander off
+static void runPlayerBenchmark(void *context, long long opsSize)
+{
+    static const PlayerInput INPUTS[] = {
+        INPUT_RIGHT, INPUT_RIGHT | INPUT_JUMP, INPUT_LEFT | INPUT_BOOST,
+        INPUT_LEFT | INPUT_JUMP, 0,
+    };
+    const int inputsSize = sizeof(INPUTS) / sizeof(INPUTS[0]);
+
+    PlayerBenchmark *benchmark = context;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const long long tick = benchmark->tick++;
+        if (tick % 8192 == 0) benchmark->player = getDefaultPlayer();
+        updatePlayer(&benchmark->player, INPUTS[(tick / 128) % inputsSize],
+                     &benchmark->level, PHYSICS_DELTA);
+    }
+    benchmarkSink = benchmark->player.rect.x;
+}
+
+// Broadphase scans of a whole level, as physics falls back to when its
+// grid can't narrow things down
+typedef struct OverlapBenchmark
+{
+    PlayerBenchmark platforms;
+    Rectangle areas[BENCHMARK_VALUES_SIZE];
+    int results[PHYSICS_MAX_CANDIDATES];
+} OverlapBenchmark;
+
+// Player sized areas anywhere over the platforms
+static void setupOverlapBenchmark(void *context)
+{
+    OverlapBenchmark *benchmark = context;
+    setupPlayerBenchmark(&benchmark->platforms);
+    const int side = (int)(sqrt(benchmark->platforms.platformsSize) * 400);
+    unsigned int seed = 2;
+    for (int i = 0; i < BENCHMARK_VALUES_SIZE; i++)
+        benchmark->areas[i] = (Rectangle){
+            getRandomFloat(&seed, -side / 2, side / 2),
+            getRandomFloat(&seed, 1000 - side, 1000), 40, 60
+        };
+}
+
+static void teardownOverlapBenchmark(void *context)
+{
+    OverlapBenchmark *benchmark = context;
+    teardownPlayerBenchmark(&benchmark->platforms);
+}
+
+static void runFindLevelOverlaps(void *context, long long opsSize)
+{
+    OverlapBenchmark *benchmark = context;
+    int hitsSize = 0;
+    for (long long i = 0; i < opsSize; i++)
+        hitsSize += findLevelOverlaps(&benchmark->platforms.level.geometry,
+            benchmark->areas[i & (BENCHMARK_VALUES_SIZE - 1)],
+            benchmark->results, PHYSICS_MAX_CANDIDATES);
+    benchmarkSink = hitsSize;
+}
+
+// The element at a time scan findLevelOverlaps replaced
+static void runFindLevelOverlapsScalar(void *context, long long opsSize)
+{
+    OverlapBenchmark *benchmark = context;
+    const LevelGeometry *geometry = &benchmark->platforms.level.geometry;
+    int hitsSize = 0;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const Rectangle area = benchmark->areas[i & (BENCHMARK_VALUES_SIZE - 1)];
+        const float right = area.x + area.width;
+        const float bottom = area.y + area.height;
+        int resultsSize = 0;
+        for (int j = 0; j < geometry->size; j++)
+            if (geometry->x[j] <= right
+             && geometry->x[j] + geometry->width[j] >= area.x
+             && geometry->y[j] <= bottom
+             && geometry->y[j] + geometry->height[j] >= area.y
+             && resultsSize < PHYSICS_MAX_CANDIDATES)
+                benchmark->results[resultsSize++] = j;
+        hitsSize += resultsSize;
+    }
+    benchmarkSink = hitsSize;
+}
+
+static void runCheckCollisionRecs(void *context, long long opsSize)
+{
+    (void)context;
+    int hitsSize = 0;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        const int b = (i * 7 + 1) & (BENCHMARK_VALUES_SIZE - 1);
+        hitsSize += CheckCollisionRecs(rectangleValues[a], rectangleValues[b]);
+    }
+    benchmarkSink = hitsSize;
+}
+
+// Each raymath op reads inputs that change every iteration and folds its
+// result into an accumulator, so nothing can be hoisted out of the loop
+
+static void runVector2Add(void *context, long long opsSize)
+{
+    (void)context;
+    Vector2 total = {0};
+    for (long long i = 0; i < opsSize; i++)
+        total = Vector2Add(total,
+                           vector2Values[i & (BENCHMARK_VALUES_SIZE - 1)]);
+    benchmarkSink = total.x + total.y;
+}
+
+static void runVector2Lerp(void *context, long long opsSize)
+{
+    (void)context;
+    Vector2 total = {0};
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        total = Vector2Add(total, Vector2Lerp(vector2Values[a],
+                                              vector2Values[a ^ 1], 0.25f));
+    }
+    benchmarkSink = total.x + total.y;
+}
+
+static void runVector2Normalize(void *context, long long opsSize)
+{
+    (void)context;
+    Vector2 total = {0};
+    for (long long i = 0; i < opsSize; i++)
+        total = Vector2Add(total, Vector2Normalize(
+            vector2Values[i & (BENCHMARK_VALUES_SIZE - 1)]));
+    benchmarkSink = total.x + total.y;
+}
+
+static void runVector2Rotate(void *context, long long opsSize)
+{
+    (void)context;
+    Vector2 total = {0};
+    for (long long i = 0; i < opsSize; i++)
+        total = Vector2Add(total, Vector2Rotate(
+            vector2Values[i & (BENCHMARK_VALUES_SIZE - 1)], 30.0f));
+    benchmarkSink = total.x + total.y;
+}
+
+static void runVector3Transform(void *context, long long opsSize)
+{
+    (void)context;
+    Vector3 total = {0};
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        total = Vector3Add(total, Vector3Transform(vector3Values[a],
+                                                   matrixValues[a ^ 1]));
+    }
+    benchmarkSink = total.x + total.y + total.z;
+}
+
+// Whole matrices get stored, otherwise only the elements read afterwards
+// would be worked out
+
+static void runMatrixMultiply(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        matrixResults[a] = MatrixMultiply(matrixValues[a], matrixValues[a ^ 1]);
+    }
+    benchmarkSink = matrixResults[0].m0;
+}
+
+static void runMatrixInvert(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        matrixResults[a] = MatrixInvert(matrixValues[a]);
+    }
+    benchmarkSink = matrixResults[0].m0;
+}
+
+static void runMatrixTranspose(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (BENCHMARK_VALUES_SIZE - 1);
+        matrixResults[a] = MatrixTranspose(matrixValues[a]);
+    }
+    benchmarkSink = matrixResults[0].m0;
+}
+
+// raymath without its SSE paths, for comparison
+
+static void runScalarMultiply(void *context, long long opsSize)
+{
+    (void)context;
+    runScalarMatrixMultiply(matrixValues, matrixResults,
+                           BENCHMARK_VALUES_SIZE, opsSize);
+    benchmarkSink = matrixResults[0].m0;
+}
+
+static void runScalarInvert(void *context, long long opsSize)
+{
+    (void)context;
+    runScalarMatrixInvert(matrixValues, matrixResults,
+                           BENCHMARK_VALUES_SIZE, opsSize);
+    benchmarkSink = matrixResults[0].m0;
+}
+
+static void runScalarTranspose(void *context, long long opsSize)
+{
+    (void)context;
+    runScalarMatrixTranspose(matrixValues, matrixResults,
+                           BENCHMARK_VALUES_SIZE, opsSize);
+    benchmarkSink = matrixResults[0].m0;
+}
+
+// The array versions from vectors.c. One op is one element, so these
+// line up with the single value functions above.
+
+static int getChunkSize(long long opsLeft)
+{
+    return opsLeft < BENCHMARK_VALUES_SIZE ? opsLeft : BENCHMARK_VALUES_SIZE;
+}
+
+static void runAddVector2s(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long done = 0; done < opsSize; done += BENCHMARK_VALUES_SIZE)
+        addVector2s(vector2Results, vector2Results, vector2Values,
+                    getChunkSize(opsSize - done));
+    benchmarkSink = vector2Results[0].x;
+}
+
+static void runLerpVector2s(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long done = 0; done < opsSize; done += BENCHMARK_VALUES_SIZE)
+        lerpVector2s(vector2Results, vector2Values, vector2Results, 0.25f,
+                     getChunkSize(opsSize - done));
+    benchmarkSink = vector2Results[0].x;
+}
+
+static void runNormalizeVector2s(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long done = 0; done < opsSize; done += BENCHMARK_VALUES_SIZE)
+        normalizeVector2s(vector2Results, vector2Values,
+                          getChunkSize(opsSize - done));
+    benchmarkSink = vector2Results[0].x;
+}
+
+static void runTransformVector3s(void *context, long long opsSize)
+{
+    (void)context;
+    for (long long done = 0; done < opsSize; done += BENCHMARK_VALUES_SIZE)
+        transformVector3s(vector3Results, vector3Values, matrixValues[0],
+                          getChunkSize(opsSize - done));
+    benchmarkSink = vector3Results[0].x;
+}
+
+// Same values every run, so runs compare
+static void fillBenchmarkValues(void)
+{
+    unsigned int seed = 1;
+    for (int i = 0; i < BENCHMARK_VALUES_SIZE; i++)
+    {
+        vector2Values[i] = (Vector2){getRandomFloat(&seed, -100, 100),
+                                     getRandomFloat(&seed, -100, 100)};
+        vector3Values[i] = (Vector3){getRandomFloat(&seed, -100, 100),
+                                     getRandomFloat(&seed, -100, 100),
+                                     getRandomFloat(&seed, -100, 100)};
+        // Camera-like transforms, which are always invertible
+        matrixValues[i] = MatrixMultiply(
+            MatrixRotate(Vector3Normalize(vector3Values[i]),
+                         getRandomFloat(&seed, 0, 2 * PI)),
+            MatrixTranslate(getRandomFloat(&seed, -100, 100),
+                            getRandomFloat(&seed, -100, 100),
+                            getRandomFloat(&seed, -100, 100)));
+        // About half of the pairs overlap
+        rectangleValues[i] = (Rectangle){getRandomFloat(&seed, 0, 1000),
+                                         getRandomFloat(&seed, 0, 1000),
+                                         getRandomFloat(&seed, 10, 400),
+                                         getRandomFloat(&seed, 10, 400)};
+    }
+}
+
+static void addBenchmark(Benchmark benchmarks[], int *benchmarksSize,
+                         const char *name, BenchmarkFunction run)
+{
+    Benchmark *benchmark = &benchmarks[(*benchmarksSize)++];
+    *benchmark = (Benchmark){.run = run};
+    snprintf(benchmark->name, sizeof(benchmark->name), "%s", name);
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options = {
+        .repetitions = 30,
+        .repetitionSeconds = 0.01,
+        .warmupSeconds = 0.1,
+    };
+    const char *jsonFileName = NULL;
+    const char *baselineFileName = NULL;
+    double tolerance = 10;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--filter") == 0 && hasValue)
+            options.filter = argv[++i];
+        else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+            options.repetitions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--json") == 0 && hasValue)
+            jsonFileName = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && hasValue)
+            baselineFileName = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+            tolerance = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.repetitions < 1) options.repetitions = 1;
+    if (options.repetitions > BENCHMARK_MAX_REPETITIONS)
+        options.repetitions = BENCHMARK_MAX_REPETITIONS;
+
+    FILE *baselineFile = NULL;
+    if (baselineFileName != NULL)
+    {
+        baselineFile = fopen(baselineFileName, "r");
+        if (baselineFile == NULL)
+        {
+            fprintf(stderr, "Couldn't read baseline %s\n", baselineFileName);
+            return EXIT_FAILURE;
+        }
+    }
+
+    fillBenchmarkValues();
+    // Only differs if the compiler fused multiplies and adds into FMA
+    // (see raymath.h)
+    const int mismatchesSize = countMatrixMismatches(
+        matrixValues, BENCHMARK_VALUES_SIZE,
+        MatrixMultiply, MatrixInvert, MatrixTranspose);
+    if (mismatchesSize > 0)
+        printf("Warning: %d matrix results differ from raymath's scalar "
+               "code\n", mismatchesSize);
+
+    static Benchmark benchmarks[BENCHMARKS_CAPACITY];
+    int benchmarksSize = 0;
+    static const int PLAYER_PLATFORMS_SIZES[] = {10, 1000, 100000, 1000000};
+    static PlayerBenchmark playerBenchmarks[4];
+    for (int i = 0; i < 4; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "updatePlayer/%d",
+                 PLAYER_PLATFORMS_SIZES[i]);
+        playerBenchmarks[i].platformsSize = PLAYER_PLATFORMS_SIZES[i];
+        addBenchmark(benchmarks, &benchmarksSize, name, runPlayerBenchmark);
+        benchmarks[benchmarksSize - 1].setup = setupPlayerBenchmark;
+        benchmarks[benchmarksSize - 1].teardown = teardownPlayerBenchmark;
+        benchmarks[benchmarksSize - 1].context = &playerBenchmarks[i];
+    }
+    static const int OVERLAP_PLATFORMS_SIZES[] = {1000, 100000};
+    static OverlapBenchmark overlapBenchmarks[2];
+    for (int i = 0; i < 2; i++)
+    {
+        overlapBenchmarks[i].platforms.platformsSize =
+            OVERLAP_PLATFORMS_SIZES[i];
+        for (int scalar = 0; scalar < 2; scalar++)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "findLevelOverlaps/%d%s",
+                     OVERLAP_PLATFORMS_SIZES[i], scalar ? "/scalar" : "");
+            addBenchmark(benchmarks, &benchmarksSize, name, scalar
+                ? runFindLevelOverlapsScalar : runFindLevelOverlaps);
+            benchmarks[benchmarksSize - 1].setup = setupOverlapBenchmark;
+            benchmarks[benchmarksSize - 1].teardown = teardownOverlapBenchmark;
+            benchmarks[benchmarksSize - 1].context = &overlapBenchmarks[i];
+        }
+    }
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "CheckCollisionRecs", runCheckCollisionRecs);
+    addBenchmark(benchmarks, &benchmarksSize, "Vector2Add", runVector2Add);
+    addBenchmark(benchmarks, &benchmarksSize, "Vector2Lerp", runVector2Lerp);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "Vector2Normalize", runVector2Normalize);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "Vector2Rotate", runVector2Rotate);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "Vector3Transform", runVector3Transform);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "MatrixMultiply", runMatrixMultiply);
+    addBenchmark(benchmarks, &benchmarksSize, "MatrixInvert", runMatrixInvert);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "MatrixTranspose", runMatrixTranspose);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "MatrixMultiply/scalar", runScalarMultiply);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "MatrixInvert/scalar", runScalarInvert);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "MatrixTranspose/scalar", runScalarTranspose);
+    addBenchmark(benchmarks, &benchmarksSize, "addVector2s", runAddVector2s);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "lerpVector2s", runLerpVector2s);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "normalizeVector2s", runNormalizeVector2s);
+    addBenchmark(benchmarks, &benchmarksSize,
+                 "transformVector3s", runTransformVector3s);
+
+    static BenchmarkResult results[BENCHMARKS_CAPACITY];
+    int resultsSize = 0;
+    int regressionsSize = 0;
+    printf("%-32s %10s %10s %10s %10s %8s\n",
+           "benchmark (ns/op)", "median", "min", "p90", "p99", "stddev");
+    for (int i = 0; i < benchmarksSize; i++)
+    {
+        const Benchmark *benchmark = &benchmarks[i];
+        if (options.filter != NULL
+            && strstr(benchmark->name, options.filter) == NULL) continue;
+
+        if (benchmark->setup != NULL) benchmark->setup(benchmark->context);
+        const BenchmarkResult result = runBenchmark(benchmark, options);
+        if (benchmark->teardown != NULL)
+            benchmark->teardown(benchmark->context);
+        results[resultsSize++] = result;
+
+        printf("%-32s %10.2f %10.2f %10.2f %10.2f %7.1f%%",
+               result.name, result.median, result.min, result.p90, result.p99,
+               result.median > 0
+                   ? 100 * result.standardDeviation / result.median : 0.0);
+        if (baselineFile != NULL)
+        {
+            const double baseline = findBaselineMedian(baselineFile,
+                                                       result.name);
+            if (baseline > 0)
+            {
+                const double change = 100 * (result.median / baseline - 1);
+                const bool isRegression = change > tolerance;
+                printf("  %+6.1f%%%s", change,
+                       isRegression ? " REGRESSION" : "");
+                regressionsSize += isRegression;
+            }
+            else printf("  (new)");
+        }
+        printf("\n");
+    }
+
+    if (baselineFile != NULL) fclose(baselineFile);
+    if (jsonFileName != NULL
+        && !saveBenchmarkJson(results, resultsSize, jsonFileName))
+    {
+        fprintf(stderr, "Couldn't write %s\n", jsonFileName);
+        return EXIT_FAILURE;
+    }
+    if (regressionsSize > 0)
+    {
+        printf("%d benchmark(s) more than %.0f%% slower than the baseline\n",
+               regressionsSize, tolerance);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
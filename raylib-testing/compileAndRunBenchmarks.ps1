@@ -0,0 +1,16 @@
+<# Benchmark Compile & Run Script #>
+<# Same flags as the game, so the numbers match what ships #>
+
+gcc <# Compile Benchmarks with GCC #> `
+    benchmark.c <# Benchmark Harness & Cases #> `
+    physics.c <# Player Physics #> `
+    level.c <# Level Storage & Spatial Grid #> `
+    vectors.c <# Batched Vector Maths #> `
+    scalarmath.c <# Raymath Without SSE, to Compare #> `
+    platform.c <# OS Specific Helpers #> `
+    -o ./benchmark.exe <# Output File Path #> `
+    -O1 -Wall <# Optimizations and Warning Flags #> `
+    -L lib/ <# Including Library Path #> `
+    -l raylib -l opengl32 -l gdi32 -l winmm <# Including Raylib Libraries #> `
+&& `
+./benchmark.exe --json benchmark.json <# Run Benchmarks #>
@@ -3,8 +3,21 @@
 
 gcc <# Compile Game with GCC #> `
     raylib-testing.c <# Entry-Point C File #> `
+    physics.c <# Player Physics #> `
+    entities.c <# Entity Components & Systems #> `
+    fixed.c <# Fixed Point Deterministic Physics #> `
+    level.c <# Level Storage & Spatial Grid #> `
+    replay.c <# Replay Recording & Playback #> `
+    batch.c <# Multi-Threaded Physics #> `
+    profiler.c <# Frame Timing Overlay #> `
+    sprites.c <# Sprite Atlas & Batching #> `
+    assets.c <# Background Asset Loading #> `
+    world.c <# Chunked World Streaming #> `
+    sim.c <# Simulation Thread #> `
+    platform.c <# OS Specific Helpers #> `
     -o ./game.exe <# Output File Path #> `
     -O1 -Wall <# Optimizations and Warning Flags #> `
+    -pthread <# Threads for Batched Physics #> `
     -L lib/ <# Including Library Path #> `
     -l raylib -l opengl32 -l gdi32 -l winmm <# Including Raylib Libraries #> `
 && `
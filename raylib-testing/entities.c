@@ -0,0 +1,343 @@
+#include <stdlib.h>
+#include <string.h>
+#include "entities.h"
+
+static int getEntityIndex(Entity entity)
+{
+    return entity & ENTITY_INDEX_MASK;
+}
+
+static ComponentPool createComponentPool(size_t componentSize,
+                                         int entitiesCapacity)
+{
+    ComponentPool pool = {
+        .componentSize = componentSize,
+        .packedIndices = malloc(sizeof(int) * entitiesCapacity),
+    };
+    for (int i = 0; i < entitiesCapacity; i++) pool.packedIndices[i] = -1;
+    return pool;
+}
+
+static void unloadComponentPool(ComponentPool *pool)
+{
+    free(pool->data);
+    free(pool->entities);
+    free(pool->packedIndices);
+    *pool = (ComponentPool){0};
+}
+
+// Keeps packedIndices as long as the world's entity arrays
+static void growComponentPool(ComponentPool *pool, int oldEntitiesCapacity,
+                              int entitiesCapacity)
+{
+    pool->packedIndices =
+        realloc(pool->packedIndices, sizeof(int) * entitiesCapacity);
+    for (int i = oldEntitiesCapacity; i < entitiesCapacity; i++)
+        pool->packedIndices[i] = -1;
+}
+
+static void *getComponent(const ComponentPool *pool, int index)
+{
+    const int packed = pool->packedIndices[index];
+    return packed >= 0
+        ? (char *)pool->data + (size_t)packed * pool->componentSize : NULL;
+}
+
+static void *addComponent(ComponentPool *pool, Entity entity,
+                          const void *component)
+{
+    const int index = getEntityIndex(entity);
+    void *existing = getComponent(pool, index);
+    if (existing != NULL)
+    {
+        memcpy(existing, component, pool->componentSize);
+        return existing;
+    }
+
+    if (pool->size >= pool->capacity)
+    {
+        const int newCapacity = pool->capacity > 0 ? pool->capacity * 2 : 64;
+        void *newData = realloc(pool->data, pool->componentSize * newCapacity);
+        if (newData == NULL) return NULL;
+        pool->data = newData;
+        Entity *newEntities =
+            realloc(pool->entities, sizeof(Entity) * newCapacity);
+        if (newEntities == NULL) return NULL;
+        pool->entities = newEntities;
+        pool->capacity = newCapacity;
+    }
+
+    const int packed = pool->size++;
+    void *slot = (char *)pool->data + (size_t)packed * pool->componentSize;
+    memcpy(slot, component, pool->componentSize);
+    pool->entities[packed] = entity;
+    pool->packedIndices[index] = packed;
+    return slot;
+}
+
+static void removeComponent(ComponentPool *pool, int index)
+{
+    const int packed = pool->packedIndices[index];
+    if (packed < 0) return;
+
+    // Fill the gap with the last one so the array stays packed
+    const int last = --pool->size;
+    if (packed != last)
+    {
+        memcpy((char *)pool->data + (size_t)packed * pool->componentSize,
+               (char *)pool->data + (size_t)last * pool->componentSize,
+               pool->componentSize);
+        pool->entities[packed] = pool->entities[last];
+        pool->packedIndices[getEntityIndex(pool->entities[packed])] = packed;
+    }
+    pool->packedIndices[index] = -1;
+}
+
+// Contacts are kept in the bodies' packed order, so move them the same way
+static void removeBodyComponent(EntityWorld *world, int index)
+{
+    const int packed = world->bodies.packedIndices[index];
+    const int last = world->bodies.size - 1;
+    if (packed >= 0 && packed < world->contactsCapacity)
+        world->contacts[packed] = last < world->contactsCapacity
+            ? world->contacts[last] : (Contact){0};
+    removeComponent(&world->bodies, index);
+}
+
+EntityWorld createEntityWorld(int capacity)
+{
+    if (capacity < 1) capacity = 1;
+    if (capacity > ENTITY_MAX) capacity = ENTITY_MAX;
+    return (EntityWorld){
+        .generations = calloc(capacity, sizeof(unsigned int)),
+        .entitiesCapacity = capacity,
+        .freeIndices = malloc(sizeof(int) * capacity),
+        .bodies = createComponentPool(sizeof(Body), capacity),
+        .movers = createComponentPool(sizeof(Mover), capacity),
+        .animators = createComponentPool(sizeof(Animator), capacity),
+    };
+}
+
+void unloadEntityWorld(EntityWorld *world)
+{
+    free(world->generations);
+    free(world->freeIndices);
+    unloadComponentPool(&world->bodies);
+    unloadComponentPool(&world->movers);
+    unloadComponentPool(&world->animators);
+    free(world->contacts);
+    *world = (EntityWorld){0};
+}
+
+Entity createEntity(EntityWorld *world)
+{
+    int index;
+    if (world->freeIndicesSize > 0)
+        index = world->freeIndices[--world->freeIndicesSize];
+    else
+    {
+        if (world->nextIndex >= ENTITY_MAX) return ENTITY_NONE;
+        if (world->nextIndex >= world->entitiesCapacity)
+        {
+            const int oldCapacity = world->entitiesCapacity;
+            int newCapacity = oldCapacity * 2;
+            if (newCapacity > ENTITY_MAX) newCapacity = ENTITY_MAX;
+
+            world->generations = realloc(world->generations,
+                                         sizeof(unsigned int) * newCapacity);
+            memset(world->generations + oldCapacity, 0,
+                   sizeof(unsigned int) * (newCapacity - oldCapacity));
+            world->freeIndices =
+                realloc(world->freeIndices, sizeof(int) * newCapacity);
+            growComponentPool(&world->bodies, oldCapacity, newCapacity);
+            growComponentPool(&world->movers, oldCapacity, newCapacity);
+            growComponentPool(&world->animators, oldCapacity, newCapacity);
+            world->entitiesCapacity = newCapacity;
+        }
+        index = world->nextIndex++;
+    }
+
+    return world->generations[index] << ENTITY_INDEX_BITS | index;
+}
+
+bool isEntityAlive(const EntityWorld *world, Entity entity)
+{
+    const int index = getEntityIndex(entity);
+    if (entity == ENTITY_NONE || index >= world->nextIndex) return false;
+    // Generations wrap, so compare only the bits the handle keeps
+    return ((world->generations[index] << ENTITY_INDEX_BITS)
+            | (unsigned int)index) == entity;
+}
+
+void destroyEntity(EntityWorld *world, Entity entity)
+{
+    if (!isEntityAlive(world, entity)) return;
+
+    const int index = getEntityIndex(entity);
+    removeBodyComponent(world, index);
+    removeComponent(&world->movers, index);
+    removeComponent(&world->animators, index);
+    world->generations[index]++;
+    world->freeIndices[world->freeIndicesSize++] = index;
+}
+
+Entity spawnPlayerEntity(EntityWorld *world, Player player)
+{
+    const Entity entity = createEntity(world);
+    if (entity == ENTITY_NONE) return entity;
+
+    addBody(world, entity, (Body){player.rect, player.velocity});
+    addMover(world, entity, (Mover){
+        .acceleration = player.acceleration,
+        .jumpStrength = player.jumpStrength,
+        .maxBoost = player.maxBoost,
+        .boostCharge = player.boostCharge,
+        .boostStrength = player.boostStrength,
+        .direction = player.direction,
+        .isMoving = player.isMoving,
+    });
+    addAnimator(world, entity,
+                (Animator){player.currentFrame, player.timeSinceLastFrame});
+    return entity;
+}
+
+Body *addBody(EntityWorld *world, Entity entity, Body body)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    const int index = getEntityIndex(entity);
+    const bool isNew = world->bodies.packedIndices[index] < 0;
+    Body *added = addComponent(&world->bodies, entity, &body);
+
+    // A new body hasn't touched anything yet, whatever its slot last held
+    const int packed = world->bodies.packedIndices[index];
+    if (added != NULL && isNew && packed < world->contactsCapacity)
+        world->contacts[packed] = (Contact){0};
+    return added;
+}
+
+Mover *addMover(EntityWorld *world, Entity entity, Mover mover)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    return addComponent(&world->movers, entity, &mover);
+}
+
+Animator *addAnimator(EntityWorld *world, Entity entity, Animator animator)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    return addComponent(&world->animators, entity, &animator);
+}
+
+Body *getBody(const EntityWorld *world, Entity entity)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    return getComponent(&world->bodies, getEntityIndex(entity));
+}
+
+Mover *getMover(const EntityWorld *world, Entity entity)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    return getComponent(&world->movers, getEntityIndex(entity));
+}
+
+Animator *getAnimator(const EntityWorld *world, Entity entity)
+{
+    if (!isEntityAlive(world, entity)) return NULL;
+    return getComponent(&world->animators, getEntityIndex(entity));
+}
+
+const Contact *getContact(const EntityWorld *world, Entity entity)
+{
+    static const Contact noContact = {0};
+    if (!isEntityAlive(world, entity)) return NULL;
+    const int packed = world->bodies.packedIndices[getEntityIndex(entity)];
+    if (packed < 0) return NULL;
+    if (packed >= world->contactsCapacity) return &noContact;
+    return &world->contacts[packed];
+}
+
+void removeBody(EntityWorld *world, Entity entity)
+{
+    if (isEntityAlive(world, entity))
+        removeBodyComponent(world, getEntityIndex(entity));
+}
+
+void removeMover(EntityWorld *world, Entity entity)
+{
+    if (isEntityAlive(world, entity))
+        removeComponent(&world->movers, getEntityIndex(entity));
+}
+
+void removeAnimator(EntityWorld *world, Entity entity)
+{
+    if (isEntityAlive(world, entity))
+        removeComponent(&world->animators, getEntityIndex(entity));
+}
+
+// SYSTEMS
+
+static void collideBodies(EntityWorld *world, const Level *level)
+{
+    Body *bodies = world->bodies.data;
+    for (int i = 0; i < world->bodies.size; i++)
+        world->contacts[i] = resolveBodyOverlaps(&bodies[i], level);
+}
+
+// Movers without a body have nothing to move
+static void applyMovers(EntityWorld *world, float deltaTime)
+{
+    Mover *movers = world->movers.data;
+    Body *bodies = world->bodies.data;
+    for (int i = 0; i < world->movers.size; i++)
+    {
+        const int index = getEntityIndex(world->movers.entities[i]);
+        const int body = world->bodies.packedIndices[index];
+        if (body < 0) continue;
+        applyMoverRules(&movers[i], &bodies[body], world->contacts[body],
+                        deltaTime);
+    }
+}
+
+static int moveBodies(EntityWorld *world, const Level *level)
+{
+    Body *bodies = world->bodies.data;
+    int goalsSize = 0;
+    for (int i = 0; i < world->bodies.size; i++)
+    {
+        if (moveBody(&bodies[i], level))
+            world->contacts[i].isTouchingGoal = true;
+        goalsSize += world->contacts[i].isTouchingGoal;
+    }
+    return goalsSize;
+}
+
+// Animators without a mover (effects and the like) always play
+static void animate(EntityWorld *world, float deltaTime)
+{
+    Animator *animators = world->animators.data;
+    const Mover *movers = world->movers.data;
+    for (int i = 0; i < world->animators.size; i++)
+    {
+        const int index = getEntityIndex(world->animators.entities[i]);
+        const int mover = world->movers.packedIndices[index];
+        advanceAnimator(&animators[i],
+                        mover < 0 || movers[mover].isMoving, deltaTime);
+    }
+}
+
+int updateEntities(EntityWorld *world, const Level *level, float deltaTime)
+{
+    if (world->bodies.size > world->contactsCapacity)
+    {
+        Contact *newContacts = realloc(world->contacts,
+                                       sizeof(Contact) * world->bodies.capacity);
+        if (newContacts == NULL) return 0;
+        world->contacts = newContacts;
+        world->contactsCapacity = world->bodies.capacity;
+    }
+
+    collideBodies(world, level);
+    applyMovers(world, deltaTime);
+    const int goalsSize = moveBodies(world, level);
+    animate(world, deltaTime);
+    return goalsSize;
+}
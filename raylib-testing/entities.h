@@ -0,0 +1,79 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include <stddef.h>
+#include "physics.h"
+
+// Index in the low bits, generation in the high bits, so a handle to a
+// destroyed entity never finds whatever reused its slot
+typedef unsigned int Entity;
+
+#define ENTITY_INDEX_BITS 20
+#define ENTITY_INDEX_MASK ((1u << ENTITY_INDEX_BITS) - 1)
+// The last index is never used, so no live handle can equal ENTITY_NONE
+#define ENTITY_MAX ((1 << ENTITY_INDEX_BITS) - 1)
+#define ENTITY_NONE 0xFFFFFFFFu
+
+// One component type for every entity that has it, packed with no gaps
+// so systems walk it front to back. Removing swaps the last one in.
+typedef struct ComponentPool
+{
+    void *data;
+    Entity *entities;         // Owner of each packed component
+    int size;
+    int capacity;
+    size_t componentSize;
+    int *packedIndices;       // By entity index, -1 if it has none
+} ComponentPool;
+
+// Entities are just handles; what they are comes from which components
+// they have. Body makes something collide with the level, Mover gives it
+// the player's movement rules (driven by Mover.input) and Animator steps
+// its sprite frames. A player is all three, a projectile just a Body.
+typedef struct EntityWorld
+{
+    unsigned int *generations;
+    int entitiesCapacity;
+    int *freeIndices;
+    int freeIndicesSize;
+    int nextIndex;
+
+    ComponentPool bodies;     // Body
+    ComponentPool movers;     // Mover
+    ComponentPool animators;  // Animator
+    Contact *contacts;        // Matches bodies' order, from the last update
+    int contactsCapacity;
+} EntityWorld;
+
+EntityWorld createEntityWorld(int capacity);
+void unloadEntityWorld(EntityWorld *world);
+
+// ENTITY_NONE once ENTITY_MAX entities are alive
+Entity createEntity(EntityWorld *world);
+void destroyEntity(EntityWorld *world, Entity entity);
+bool isEntityAlive(const EntityWorld *world, Entity entity);
+// Body + Mover + Animator, set up from player
+Entity spawnPlayerEntity(EntityWorld *world, Player player);
+
+// Adding replaces any existing component of that type. Getters return
+// NULL if the entity doesn't have one. Pointers last until the next add
+// or remove of that component type.
+Body *addBody(EntityWorld *world, Entity entity, Body body);
+Mover *addMover(EntityWorld *world, Entity entity, Mover mover);
+Animator *addAnimator(EntityWorld *world, Entity entity, Animator animator);
+Body *getBody(const EntityWorld *world, Entity entity);
+Mover *getMover(const EntityWorld *world, Entity entity);
+Animator *getAnimator(const EntityWorld *world, Entity entity);
+// What an entity's body touched during the last updateEntities (nothing
+// for a body added since), NULL if it has no body
+const Contact *getContact(const EntityWorld *world, Entity entity);
+void removeBody(EntityWorld *world, Entity entity);
+void removeMover(EntityWorld *world, Entity entity);
+void removeAnimator(EntityWorld *world, Entity entity);
+
+// Runs one tick of every system over the whole world, same order as
+// updatePlayer: overlaps, mover rules, sweeps, then animation. Returns
+// how many bodies touched a goal.
+int updateEntities(EntityWorld *world, const Level *level, float deltaTime);
+
+#endif // ENTITIES_H
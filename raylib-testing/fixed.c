@@ -0,0 +1,406 @@
+#include "fixed.h"
+
+// Must match PHYSICS_DELTA
+#define FIXED_TICKS_PER_SECOND 128
+// Animation frames last 1/30 s, which the float version also only
+// notices on the first whole tick past it
+#define FIXED_TICKS_PER_ANIMATION_FRAME 5
+
+static const Fixed FIXED_GROUND_FRICTION =
+    FIXED_CONSTANT(0.50 / FIXED_TICKS_PER_SECOND);
+static const Fixed FIXED_AIR_FRICTION =
+    FIXED_CONSTANT(0.40 / FIXED_TICKS_PER_SECOND);
+static const Fixed FIXED_GRAVITY_STEP =
+    FIXED_CONSTANT(9.8 / FIXED_TICKS_PER_SECOND);
+static const Fixed FIXED_BOOST_RECHARGE =
+    FIXED_CONSTANT(40.0 / FIXED_TICKS_PER_SECOND);
+static const Fixed FIXED_BOOST_DRAIN =
+    FIXED_CONSTANT(100.0 / FIXED_TICKS_PER_SECOND);
+
+Fixed fixedFromFloat(float value)
+{
+    if (!(value < 32767.0f)) return INT32_MAX;
+    if (value <= -32768.0f) return INT32_MIN;
+    return (Fixed)(value * FIXED_ONE);
+}
+
+// Fraction a / b, clamped to what Fixed can hold
+static Fixed fixedDiv(Fixed a, Fixed b)
+{
+    const int64_t quotient = (int64_t)a * FIXED_ONE / b;
+    if (quotient > INT32_MAX) return INT32_MAX;
+    if (quotient < INT32_MIN) return INT32_MIN;
+    return (Fixed)quotient;
+}
+
+static Fixed fixedMax(Fixed a, Fixed b) { return a > b ? a : b; }
+static Fixed fixedMin(Fixed a, Fixed b) { return a < b ? a : b; }
+static Fixed fixedAbs(Fixed a) { return a < 0 ? -a : a; }
+
+static FixedRect getElementRect(const LevelGeometry *geometry, int i)
+{
+    return (FixedRect){
+        fixedFromFloat(geometry->x[i]), fixedFromFloat(geometry->y[i]),
+        fixedFromFloat(geometry->width[i]), fixedFromFloat(geometry->height[i])
+    };
+}
+
+// The broadphase works in floats, but its area is padded well past
+// anything the fixed point maths could reach, so rounding never changes
+// which elements matter
+static int findFixedCandidates(const Level *level, FixedRect area,
+                               int candidates[])
+{
+    return findCollisionCandidates(level, (Rectangle){
+        fixedToFloat(area.x) - 1, fixedToFloat(area.y) - 1,
+        fixedToFloat(area.width) + 2, fixedToFloat(area.height) + 2
+    }, candidates);
+}
+
+FixedPlayer createFixedPlayer(Player player)
+{
+    return (FixedPlayer){
+        .rect = {
+            fixedFromFloat(player.rect.x), fixedFromFloat(player.rect.y),
+            fixedFromFloat(player.rect.width), fixedFromFloat(player.rect.height)
+        },
+        .velocityX = fixedFromFloat(player.velocity.x),
+        .velocityY = fixedFromFloat(player.velocity.y),
+        .acceleration = fixedFromFloat(player.acceleration),
+        .jumpStrength = fixedFromFloat(player.jumpStrength),
+        .maxBoost = fixedFromFloat(player.maxBoost),
+        .boostCharge = fixedFromFloat(player.boostCharge),
+        .boostStrength = fixedFromFloat(player.boostStrength),
+        .direction = player.direction,
+        .isMoving = player.isMoving,
+        .currentFrame = player.currentFrame,
+        .ticksSinceLastFrame =
+            (int32_t)(player.timeSinceLastFrame * FIXED_TICKS_PER_SECOND),
+    };
+}
+
+void applyFixedPlayer(Player *player, const FixedPlayer *fixedPlayer)
+{
+    player->rect = (Rectangle){
+        fixedToFloat(fixedPlayer->rect.x), fixedToFloat(fixedPlayer->rect.y),
+        fixedToFloat(fixedPlayer->rect.width),
+        fixedToFloat(fixedPlayer->rect.height)
+    };
+    player->velocity = (Vector2){
+        fixedToFloat(fixedPlayer->velocityX),
+        fixedToFloat(fixedPlayer->velocityY)
+    };
+    player->boostCharge = fixedToFloat(fixedPlayer->boostCharge);
+    player->direction = fixedPlayer->direction;
+    player->isMoving = fixedPlayer->isMoving;
+    player->currentFrame = fixedPlayer->currentFrame;
+    player->timeSinceLastFrame =
+        (float)fixedPlayer->ticksSinceLastFrame / FIXED_TICKS_PER_SECOND;
+}
+
+// Same as resolveBodyOverlaps, which already works on truncated ints
+static Contact resolveFixedOverlaps(FixedPlayer *player, const Level *level)
+{
+    const LevelGeometry *geometry = &level->geometry;
+    Contact contact = {0};
+
+    const FixedRect r = player->rect;
+    const Fixed padX = fixedAdd(fixedAdd(fixedAbs(player->velocityX), r.width),
+                                FIXED_ONE);
+    const Fixed padY = fixedAdd(fixedAdd(fixedAbs(player->velocityY), r.height),
+                                FIXED_ONE);
+    const FixedRect area = {
+        fixedSub(r.x, padX), fixedSub(r.y, padY),
+        fixedAdd(r.width, fixedAdd(padX, padX)),
+        fixedAdd(r.height, fixedAdd(padY, padY))
+    };
+    int candidates[PHYSICS_MAX_CANDIDATES];
+    const int candidatesSize = findFixedCandidates(level, area, candidates);
+    const int checksSize = candidatesSize >= 0 ? candidatesSize : geometry->size;
+
+    int pX = fixedToInt(player->rect.x), pY = fixedToInt(player->rect.y),
+        pH = fixedToInt(player->rect.height), pW = fixedToInt(player->rect.width);
+    for (int c = 0; c < checksSize; c++)
+    {
+        const int i = candidatesSize >= 0 ? candidates[c] : c;
+        // Parked (sentinel) elements have no state, so skip before
+        // converting anything
+        if (geometry->state[i] == 0) continue;
+
+        const FixedRect e = getElementRect(geometry, i);
+        const FixedRect p = player->rect;
+        if (checkUnsignedIntBit(geometry->state[i], 1)
+         && p.x < fixedAdd(e.x, e.width) && fixedAdd(p.x, p.width) > e.x
+         && p.y < fixedAdd(e.y, e.height) && fixedAdd(p.y, p.height) > e.y)
+        {
+            contact.isTouchingGoal = true;
+        }
+
+        // Check for collidable flag (first bit)
+        if (!checkUnsignedIntBit(geometry->state[i], 0)) continue;
+
+        const int eX = fixedToInt(e.x), eY = fixedToInt(e.y),
+                  eW = fixedToInt(e.width), eH = fixedToInt(e.height);
+        if (pY + pH > eY + COLLISION_ALLOWANCE
+         && pY < eY + eH - COLLISION_ALLOWANCE)
+        {
+            if (pX + pW > eX + eW && pX < eX + eW)
+            {
+                player->rect.x = fixedFromInt(eX + eW);
+                contact.hasHitWall = 1;
+                pX = eX + eW;
+                player->velocityX = 0;
+            }
+            if (pX < eX && pX + pW > eX)
+            {
+                player->rect.x = fixedFromInt(eX - pW);
+                contact.hasHitWall = 1;
+                pX = eX - pW;
+                player->velocityX = 0;
+            }
+        }
+        if (pX + pW > eX + COLLISION_ALLOWANCE
+         && pX < eX + eW - COLLISION_ALLOWANCE)
+        {
+            if (pY + pH > eY + eH && pY < eY + eH)
+            {
+                player->rect.y = fixedFromInt(eY + eH);
+                pY = eY + eH;
+                player->velocityY = 0;
+            }
+            if (pY <= eY && pY + pH >= eY)
+            {
+                player->rect.y = fixedFromInt(eY - pH);
+                pY = eY - pH;
+                contact.isOnGround = true;
+                player->velocityY = 0;
+            }
+        }
+    }
+
+    return contact;
+}
+
+// Same as applyMoverRules
+static void applyFixedMoverRules(FixedPlayer *player, PlayerInput input,
+                                 Contact contact)
+{
+    const bool isOnGround = contact.isOnGround;
+    const int hasHitWall = contact.hasHitWall;
+    const Fixed delta = FIXED_ONE / FIXED_TICKS_PER_SECOND;
+
+    player->velocityX = fixedMul(player->velocityX, isOnGround
+        ? FIXED_GROUND_FRICTION : FIXED_AIR_FRICTION);
+    player->isMoving = false;
+
+    if (isOnGround)
+        player->boostCharge = fixedAdd(player->boostCharge, FIXED_BOOST_RECHARGE);
+    if (player->boostCharge > player->maxBoost)
+        player->boostCharge = player->maxBoost;
+    if (!isOnGround)
+        player->velocityY = fixedAdd(player->velocityY, FIXED_GRAVITY_STEP);
+    if (input & INPUT_RIGHT) {
+        if (hasHitWall <= 0)
+            player->velocityX = fixedAdd(player->velocityX,
+                                         fixedMul(player->acceleration, delta));
+        player->direction = 1;
+        player->isMoving = true;
+    }
+    if (input & INPUT_LEFT) {
+        if (hasHitWall >= 0)
+            player->velocityX = fixedSub(player->velocityX,
+                                         fixedMul(player->acceleration, delta));
+        player->direction = 0;
+        player->isMoving = true;
+    }
+    if ((input & INPUT_JUMP) && isOnGround)
+        player->velocityY = fixedSub(player->velocityY, player->jumpStrength);
+    if ((input & INPUT_BOOST)
+     && !isOnGround
+     && (input & (INPUT_LEFT | INPUT_RIGHT))
+     && player->boostCharge > 0)
+    {
+        player->boostCharge = fixedSub(player->boostCharge, FIXED_BOOST_DRAIN);
+        if (player->boostCharge < 0)
+            player->boostCharge = 0;
+        player->velocityX = fixedMul(player->velocityX, player->boostStrength);
+    }
+}
+
+// Same as sweepBox. Times are fractions of the move, FIXED_ONE being all
+// of it.
+static Fixed sweepFixedBox(FixedRect box, Fixed dx, Fixed dy,
+                           FixedRect target, bool *isHitX)
+{
+    Fixed entryX, exitX, entryY, exitY;
+
+    if (dx > 0)
+    {
+        entryX = fixedDiv(fixedSub(target.x, fixedAdd(box.x, box.width)), dx);
+        exitX = fixedDiv(fixedSub(fixedAdd(target.x, target.width), box.x), dx);
+    }
+    else if (dx < 0)
+    {
+        entryX = fixedDiv(fixedSub(fixedAdd(target.x, target.width), box.x), dx);
+        exitX = fixedDiv(fixedSub(target.x, fixedAdd(box.x, box.width)), dx);
+    }
+    else if (box.x < fixedAdd(target.x, target.width)
+          && fixedAdd(box.x, box.width) > target.x)
+    {
+        entryX = INT32_MIN;
+        exitX = INT32_MAX;
+    }
+    else return -1;
+
+    if (dy > 0)
+    {
+        entryY = fixedDiv(fixedSub(target.y, fixedAdd(box.y, box.height)), dy);
+        exitY = fixedDiv(fixedSub(fixedAdd(target.y, target.height), box.y), dy);
+    }
+    else if (dy < 0)
+    {
+        entryY = fixedDiv(fixedSub(fixedAdd(target.y, target.height), box.y), dy);
+        exitY = fixedDiv(fixedSub(target.y, fixedAdd(box.y, box.height)), dy);
+    }
+    else if (box.y < fixedAdd(target.y, target.height)
+          && fixedAdd(box.y, box.height) > target.y)
+    {
+        entryY = INT32_MIN;
+        exitY = INT32_MAX;
+    }
+    else return -1;
+
+    const Fixed entry = fixedMax(entryX, entryY);
+    const Fixed exit = fixedMin(exitX, exitY);
+    if (entry >= exit || entry < 0 || entry > FIXED_ONE) return -1;
+
+    *isHitX = entryX > entryY;
+    return entry;
+}
+
+// Same as moveBody
+static bool moveFixedPlayer(FixedPlayer *player, const Level *level)
+{
+    const LevelGeometry *geometry = &level->geometry;
+    FixedRect *rect = &player->rect;
+    Fixed dx = player->velocityX, dy = player->velocityY;
+    if (dx == 0 && dy == 0) return false;
+
+    const FixedRect area = {
+        fixedMin(rect->x, fixedAdd(rect->x, dx)),
+        fixedMin(rect->y, fixedAdd(rect->y, dy)),
+        fixedAdd(rect->width, fixedAbs(dx)),
+        fixedAdd(rect->height, fixedAbs(dy))
+    };
+    int candidates[PHYSICS_MAX_CANDIDATES];
+    const int candidatesSize = findFixedCandidates(level, area, candidates);
+    const int checksSize = candidatesSize >= 0 ? candidatesSize : geometry->size;
+
+    bool isTouchingGoal = false;
+    for (int pass = 0; pass < 3 && (dx != 0 || dy != 0); pass++)
+    {
+        Fixed firstHit = FIXED_ONE;
+        int hitIndex = -1;
+        bool isHitX = false;
+        Fixed goalHit = -1;
+        FixedRect hitRect = {0};
+
+        for (int c = 0; c < checksSize; c++)
+        {
+            const int i = candidatesSize >= 0 ? candidates[c] : c;
+            if (geometry->state[i] == 0) continue;
+
+            const FixedRect e = getElementRect(geometry, i);
+            bool isX;
+            const Fixed t = sweepFixedBox(*rect, dx, dy, e, &isX);
+            if (t < 0) continue;
+
+            if (checkUnsignedIntBit(geometry->state[i], 1)
+             && (goalHit < 0 || t < goalHit))
+                goalHit = t;
+            if (checkUnsignedIntBit(geometry->state[i], 0) && t < firstHit)
+            {
+                firstHit = t;
+                hitIndex = i;
+                hitRect = e;
+                isHitX = isX;
+            }
+        }
+        if (goalHit >= 0 && goalHit <= firstHit) isTouchingGoal = true;
+
+        rect->x = fixedAdd(rect->x, fixedMul(dx, firstHit));
+        rect->y = fixedAdd(rect->y, fixedMul(dy, firstHit));
+        if (hitIndex < 0) break;
+
+        if (isHitX)
+        {
+            rect->x = dx > 0 ? fixedSub(hitRect.x, rect->width)
+                             : fixedAdd(hitRect.x, hitRect.width);
+            player->velocityX = 0;
+            dx = 0;
+            dy = fixedMul(dy, FIXED_ONE - firstHit);
+        }
+        else
+        {
+            rect->y = dy > 0 ? fixedSub(hitRect.y, rect->height)
+                             : fixedAdd(hitRect.y, hitRect.height);
+            player->velocityY = 0;
+            dy = 0;
+            dx = fixedMul(dx, FIXED_ONE - firstHit);
+        }
+    }
+
+    return isTouchingGoal;
+}
+
+bool updateFixedPlayer(FixedPlayer *player, PlayerInput input,
+                       const Level *level)
+{
+    player->ticksSinceLastFrame++;
+
+    Contact contact = resolveFixedOverlaps(player, level);
+    applyFixedMoverRules(player, input, contact);
+    if (moveFixedPlayer(player, level))
+        contact.isTouchingGoal = true;
+
+    if (player->isMoving
+     && player->ticksSinceLastFrame >= FIXED_TICKS_PER_ANIMATION_FRAME)
+    {
+        player->currentFrame = (player->currentFrame + 1) % 10;
+        player->ticksSinceLastFrame = 0;
+    }
+    if (!player->isMoving)
+    {
+        player->currentFrame = 0;
+        player->ticksSinceLastFrame = 0;
+    }
+
+    return contact.isTouchingGoal;
+}
+
+static uint64_t hashWord(uint64_t hash, int32_t word)
+{
+    // Little endian byte by byte, whatever the machine's order
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        hash ^= ((uint32_t)word >> shift) & 0xFF;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t hashFixedPlayer(const FixedPlayer *player)
+{
+    const int32_t words[] = {
+        player->rect.x, player->rect.y, player->rect.width, player->rect.height,
+        player->velocityX, player->velocityY, player->acceleration,
+        player->jumpStrength, player->maxBoost, player->boostCharge,
+        player->boostStrength, player->direction, player->isMoving,
+        player->currentFrame, player->ticksSinceLastFrame,
+    };
+
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        hash = hashWord(hash, words[i]);
+    return hash;
+}
@@ -0,0 +1,93 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include "physics.h"
+
+// Q16.16 fixed point. Only integer maths touches it, so the same inputs
+// give the same bits on every compiler, flag set and machine, which float
+// physics can't promise (FMA contraction, x87 precision, -ffast-math).
+typedef int32_t Fixed;
+
+#define FIXED_ONE (1 << 16)
+// Compile time constants only; the double maths happens in the compiler
+#define FIXED_CONSTANT(value) \
+    ((Fixed)((value) * FIXED_ONE + ((value) < 0 ? -0.5 : 0.5)))
+
+// Overflow wraps (rather than being undefined) so even a body falling
+// forever stays deterministic
+static inline Fixed fixedAdd(Fixed a, Fixed b)
+{
+    return (Fixed)((uint32_t)a + (uint32_t)b);
+}
+
+static inline Fixed fixedSub(Fixed a, Fixed b)
+{
+    return (Fixed)((uint32_t)a - (uint32_t)b);
+}
+
+// Rounds toward zero, like C integer division
+static inline Fixed fixedMul(Fixed a, Fixed b)
+{
+    return (Fixed)(((int64_t)a * b) / FIXED_ONE);
+}
+
+static inline Fixed fixedFromInt(int value)
+{
+    return (Fixed)((uint32_t)value << 16);
+}
+
+// Rounds toward zero, the same as casting a float to int
+static inline int fixedToInt(Fixed value)
+{
+    return value / FIXED_ONE;
+}
+
+static inline float fixedToFloat(Fixed value)
+{
+    return value / (float)FIXED_ONE;
+}
+
+typedef struct FixedRect
+{
+    Fixed x;
+    Fixed y;
+    Fixed width;
+    Fixed height;
+} FixedRect;
+
+// Player state for the fixed point physics mode. Always steps by
+// PHYSICS_DELTA, and counts animation time in ticks.
+typedef struct FixedPlayer
+{
+    FixedRect rect;
+    Fixed velocityX;
+    Fixed velocityY;
+    Fixed acceleration;
+    Fixed jumpStrength;
+    Fixed maxBoost;
+    Fixed boostCharge;
+    Fixed boostStrength;
+    int32_t direction;
+    int32_t isMoving;
+    int32_t currentFrame;
+    int32_t ticksSinceLastFrame;
+} FixedPlayer;
+
+// Saturates anything out of Q16.16's range (level sentinels included)
+Fixed fixedFromFloat(float value);
+
+FixedPlayer createFixedPlayer(Player player);
+// Copies what drawing and the camera need back into a float player
+void applyFixedPlayer(Player *player, const FixedPlayer *fixedPlayer);
+
+// updatePlayer's rules in fixed point, one PHYSICS_DELTA tick at a time.
+// Level coordinates are converted exactly, so they should stay within
+// +-32767.
+bool updateFixedPlayer(FixedPlayer *player, PlayerInput input,
+                       const Level *level);
+// FNV-1a over every field, byte order included, so runs on different
+// machines can be compared with one number
+uint64_t hashFixedPlayer(const FixedPlayer *player);
+
+#endif // FIXED_H
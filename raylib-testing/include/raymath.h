@@ -49,6 +49,22 @@
     #include "raylib.h"           // Required for structs: Vector3, Matrix
 #endif
 
+// SSE versions of MatrixMultiply(), MatrixInvert() and MatrixTranspose()
+// NOTE: They do the same float operations in the same order as the scalar code,
+// so results are bit-identical (0 ULP) unless the compiler contracts multiplies
+// and adds into FMA instructions (-mfma or -march=native, without
+// -ffp-contract=off). It can then fuse either version differently:
+// - MatrixTranspose() stays exact, it does no arithmetic
+// - MatrixMultiply() was measured within 1 ULP of the product of the two inputs'
+//   largest elements (so near-zero elements can be many of their own ULPs off)
+// - MatrixInvert() has no bound, the determinant can cancel to almost nothing
+// Build with -ffp-contract=off to keep them bit-identical with FMA enabled.
+// Define RAYMATH_NO_SIMD to always use the scalar code.
+#if defined(__SSE__) && !defined(RAYMATH_NO_SIMD)
+    #define RAYMATH_SSE
+    #include <xmmintrin.h>
+#endif
+
 #if defined(RAYMATH_IMPLEMENTATION) && defined(RAYMATH_HEADER_ONLY)
     #error "Specifying both RAYMATH_IMPLEMENTATION and RAYMATH_HEADER_ONLY is contradictory"
 #endif
@@ -656,6 +672,21 @@ RMDEF Matrix MatrixTranspose(Matrix mat)
 {
     Matrix result = { 0 };
 
+#if defined(RAYMATH_SSE)
+    // NOTE: Matrix fields are laid out m0, m4, m8, m12, m1, ... so each group of
+    // four floats in memory holds one row
+    __m128 row0 = _mm_loadu_ps(&mat.m0);
+    __m128 row1 = _mm_loadu_ps(&mat.m1);
+    __m128 row2 = _mm_loadu_ps(&mat.m2);
+    __m128 row3 = _mm_loadu_ps(&mat.m3);
+
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    _mm_storeu_ps(&result.m0, row0);
+    _mm_storeu_ps(&result.m1, row1);
+    _mm_storeu_ps(&result.m2, row2);
+    _mm_storeu_ps(&result.m3, row3);
+#else
     result.m0 = mat.m0;
     result.m1 = mat.m4;
     result.m2 = mat.m8;
@@ -672,6 +703,7 @@ RMDEF Matrix MatrixTranspose(Matrix mat)
     result.m13 = mat.m7;
     result.m14 = mat.m11;
     result.m15 = mat.m15;
+#endif
 
     return result;
 }
@@ -681,6 +713,54 @@ RMDEF Matrix MatrixInvert(Matrix mat)
 {
     Matrix result = { 0 };
 
+#if defined(RAYMATH_SSE)
+    // Registers a0..a3 hold [ai0, ai1, ai2, ai3] as named in the scalar code below
+    __m128 a0 = _mm_loadu_ps(&mat.m0);
+    __m128 a1 = _mm_loadu_ps(&mat.m1);
+    __m128 a2 = _mm_loadu_ps(&mat.m2);
+    __m128 a3 = _mm_loadu_ps(&mat.m3);
+    _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+
+    // 2x2 determinants: low holds b00..b03 and lowEnd b02..b05, high and highEnd the same for b06..b11
+    #define RAYMATH_MINORS(x, y, p, q) _mm_sub_ps( \
+        _mm_mul_ps(_mm_shuffle_ps(x, x, p), _mm_shuffle_ps(y, y, q)), \
+        _mm_mul_ps(_mm_shuffle_ps(x, x, q), _mm_shuffle_ps(y, y, p)))
+    __m128 low = RAYMATH_MINORS(a0, a1, _MM_SHUFFLE(1, 0, 0, 0), _MM_SHUFFLE(2, 3, 2, 1));
+    __m128 lowEnd = RAYMATH_MINORS(a0, a1, _MM_SHUFFLE(2, 1, 1, 0), _MM_SHUFFLE(3, 3, 2, 3));
+    __m128 high = RAYMATH_MINORS(a2, a3, _MM_SHUFFLE(1, 0, 0, 0), _MM_SHUFFLE(2, 3, 2, 1));
+    __m128 highEnd = RAYMATH_MINORS(a2, a3, _MM_SHUFFLE(2, 1, 1, 0), _MM_SHUFFLE(3, 3, 2, 3));
+    #undef RAYMATH_MINORS
+
+    float b[12];
+    _mm_storeu_ps(b, low);
+    _mm_storeu_ps(b + 2, lowEnd);
+    _mm_storeu_ps(b + 6, high);
+    _mm_storeu_ps(b + 8, highEnd);
+
+    // Calculate the invert determinant (same expression as the scalar code)
+    __m128 invDet = _mm_set1_ps(1.0f/(b[0]*b[11] - b[1]*b[10] + b[2]*b[9] + b[3]*b[8] - b[4]*b[7] + b[5]*b[6]));
+
+    // Each result row is (x1*y1 + x2*y2 + x3*y3)*invDet with alternating signs per lane,
+    // rows 0 and 1 taking their b terms from b06..b11 and rows 2 and 3 from b00..b05
+    __m128 highY1 = _mm_shuffle_ps(highEnd, highEnd, _MM_SHUFFLE(1, 2, 3, 3));     // b11 b11 b10 b09
+    __m128 highY2 = _mm_shuffle_ps(highEnd, high, _MM_SHUFFLE(1, 2, 0, 2));        // b10 b08 b08 b07
+    __m128 highY3 = _mm_shuffle_ps(high, high, _MM_SHUFFLE(0, 0, 1, 3));           // b09 b07 b06 b06
+    __m128 lowY1 = _mm_shuffle_ps(lowEnd, lowEnd, _MM_SHUFFLE(1, 2, 3, 3));        // b05 b05 b04 b03
+    __m128 lowY2 = _mm_shuffle_ps(lowEnd, low, _MM_SHUFFLE(1, 2, 0, 2));           // b04 b02 b02 b01
+    __m128 lowY3 = _mm_shuffle_ps(low, low, _MM_SHUFFLE(0, 0, 1, 3));              // b03 b01 b00 b00
+
+    __m128 plusMinus = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    __m128 minusPlus = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    #define RAYMATH_COFACTORS(x, y1, y2, y3, sign, otherSign) _mm_mul_ps(_mm_add_ps(_mm_add_ps( \
+        _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 1)), y1), sign), \
+        _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 2, 2)), y2), otherSign)), \
+        _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 3, 3)), y3), sign)), invDet)
+    _mm_storeu_ps(&result.m0, RAYMATH_COFACTORS(a1, highY1, highY2, highY3, plusMinus, minusPlus));
+    _mm_storeu_ps(&result.m1, RAYMATH_COFACTORS(a0, highY1, highY2, highY3, minusPlus, plusMinus));
+    _mm_storeu_ps(&result.m2, RAYMATH_COFACTORS(a3, lowY1, lowY2, lowY3, plusMinus, minusPlus));
+    _mm_storeu_ps(&result.m3, RAYMATH_COFACTORS(a2, lowY1, lowY2, lowY3, minusPlus, plusMinus));
+    #undef RAYMATH_COFACTORS
+#else
     // Cache the matrix values (speed optimization)
     float a00 = mat.m0, a01 = mat.m1, a02 = mat.m2, a03 = mat.m3;
     float a10 = mat.m4, a11 = mat.m5, a12 = mat.m6, a13 = mat.m7;
@@ -719,6 +799,7 @@ RMDEF Matrix MatrixInvert(Matrix mat)
     result.m13 = (a00*b09 - a01*b07 + a02*b06)*invDet;
     result.m14 = (-a30*b03 + a31*b01 - a32*b00)*invDet;
     result.m15 = (a20*b03 - a21*b01 + a22*b00)*invDet;
+#endif
 
     return result;
 }
@@ -817,6 +898,30 @@ RMDEF Matrix MatrixMultiply(Matrix left, Matrix right)
 {
     Matrix result = { 0 };
 
+#if defined(RAYMATH_SSE)
+    // NOTE: Each group of four floats in memory is one row: [m0 m4 m8 m12], [m1 m5 m9 m13]...
+    // result row j = left row 0*right.m(j) + left row 1*right.m(4 + j) + ..., summed in scalar order
+    __m128 leftRow0 = _mm_loadu_ps(&left.m0);
+    __m128 leftRow1 = _mm_loadu_ps(&left.m1);
+    __m128 leftRow2 = _mm_loadu_ps(&left.m2);
+    __m128 leftRow3 = _mm_loadu_ps(&left.m3);
+
+    #define RAYMATH_PRODUCT_ROW(rightRow) _mm_add_ps(_mm_add_ps(_mm_add_ps( \
+        _mm_mul_ps(leftRow0, _mm_shuffle_ps(rightRow, rightRow, _MM_SHUFFLE(0, 0, 0, 0))), \
+        _mm_mul_ps(leftRow1, _mm_shuffle_ps(rightRow, rightRow, _MM_SHUFFLE(1, 1, 1, 1)))), \
+        _mm_mul_ps(leftRow2, _mm_shuffle_ps(rightRow, rightRow, _MM_SHUFFLE(2, 2, 2, 2)))), \
+        _mm_mul_ps(leftRow3, _mm_shuffle_ps(rightRow, rightRow, _MM_SHUFFLE(3, 3, 3, 3))))
+    __m128 row0 = RAYMATH_PRODUCT_ROW(_mm_loadu_ps(&right.m0));
+    __m128 row1 = RAYMATH_PRODUCT_ROW(_mm_loadu_ps(&right.m1));
+    __m128 row2 = RAYMATH_PRODUCT_ROW(_mm_loadu_ps(&right.m2));
+    __m128 row3 = RAYMATH_PRODUCT_ROW(_mm_loadu_ps(&right.m3));
+    #undef RAYMATH_PRODUCT_ROW
+
+    _mm_storeu_ps(&result.m0, row0);
+    _mm_storeu_ps(&result.m1, row1);
+    _mm_storeu_ps(&result.m2, row2);
+    _mm_storeu_ps(&result.m3, row3);
+#else
     result.m0 = left.m0*right.m0 + left.m1*right.m4 + left.m2*right.m8 + left.m3*right.m12;
     result.m1 = left.m0*right.m1 + left.m1*right.m5 + left.m2*right.m9 + left.m3*right.m13;
     result.m2 = left.m0*right.m2 + left.m1*right.m6 + left.m2*right.m10 + left.m3*right.m14;
@@ -833,6 +938,7 @@ RMDEF Matrix MatrixMultiply(Matrix left, Matrix right)
     result.m13 = left.m12*right.m1 + left.m13*right.m5 + left.m14*right.m9 + left.m15*right.m13;
     result.m14 = left.m12*right.m2 + left.m13*right.m6 + left.m14*right.m10 + left.m15*right.m14;
     result.m15 = left.m12*right.m3 + left.m13*right.m7 + left.m14*right.m11 + left.m15*right.m15;
+#endif
 
     return result;
 }
@@ -0,0 +1,806 @@
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "level.h"
+#include "platform.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
+static unsigned int hashCell(int cellX, int cellY, unsigned int mask)
+{
+    return ((unsigned int)cellX * 73856093u ^ (unsigned int)cellY * 19349663u)
+           & mask;
+}
+
+static int compareInts(const void *a, const void *b)
+{
+    const int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Only collidable (bit 0) and goal (bit 1) elements matter to physics
+static bool isPhysical(const RectangleEnv *element)
+{
+    return (element->state & 3) != 0;
+}
+
+// Anything physics or drawing could care about gets put in a grid
+static bool isIndexed(const RectangleEnv *element)
+{
+    return isPhysical(element)
+        || (element->rect.width > 0 && element->rect.height > 0
+            && element->color.a > 0);
+}
+
+static void getCellRange(Rectangle rect, float cellSize,
+                         int *minX, int *minY, int *maxX, int *maxY)
+{
+    *minX = (int)floorf(rect.x / cellSize);
+    *minY = (int)floorf(rect.y / cellSize);
+    *maxX = (int)floorf((rect.x + rect.width) / cellSize);
+    *maxY = (int)floorf((rect.y + rect.height) / cellSize);
+}
+
+Level createLevel(int capacity)
+{
+    if (capacity < 1) capacity = 1;
+    return (Level){
+        .elements = malloc(sizeof(RectangleEnv) * capacity),
+        .elementsSize = 0,
+        .elementsCapacity = capacity,
+    };
+}
+
+void unloadLevel(Level *level)
+{
+    if (level->mapping != NULL)
+    {
+        if (!level->areGridsMapped)
+        {
+            unloadSpatialGrid(&level->grid);
+            unloadSpatialGrid(&level->drawList.grid);
+        }
+        free(level->drawList.visible);
+        unmapFile(level->mapping, level->mappingSize);
+        *level = (Level){0};
+        return;
+    }
+
+    free(level->elements);
+    unloadLevelGeometry(&level->geometry);
+    unloadSpatialGrid(&level->grid);
+    unloadLevelDrawList(&level->drawList);
+    *level = (Level){0};
+}
+
+uint64_t hashLevelElement(RectangleEnv element, uint32_t index)
+{
+    // FNV-1a, little endian byte by byte whatever the machine's order
+    uint32_t words[7] = {0, 0, 0, 0, 0, element.state, index};
+    memcpy(words, &element.rect, sizeof(element.rect));
+    words[4] = element.color.r | element.color.g << 8
+             | element.color.b << 16 | (uint32_t)element.color.a << 24;
+
+    uint64_t hash = 14695981039346656037ull;
+    for (int i = 0; i < 7; i++)
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            hash ^= (words[i] >> shift) & 0xFF;
+            hash *= 1099511628211ull;
+        }
+    return hash;
+}
+
+uint64_t hashLevel(const Level *level)
+{
+    uint64_t hash = 0;
+    for (int i = 0; i < level->elementsSize; i++)
+        hash += hashLevelElement(level->elements[i], i);
+    return hash;
+}
+
+// Swaps a mapped level for an owned copy of its elements so it can be
+// changed. It needs baking again afterwards.
+static void detachLevel(Level *level)
+{
+    Level owned = createLevel(level->elementsSize);
+    memcpy(owned.elements, level->elements,
+           sizeof(RectangleEnv) * level->elementsSize);
+    owned.elementsSize = level->elementsSize;
+    unloadLevel(level);
+    *level = owned;
+}
+
+void clearLevel(Level *level)
+{
+    if (level->mapping != NULL)
+    {
+        unloadLevel(level);
+        *level = createLevel(16);
+        return;
+    }
+
+    level->elementsSize = 0;
+    unloadLevelGeometry(&level->geometry);
+    unloadSpatialGrid(&level->grid);
+    unloadLevelDrawList(&level->drawList);
+}
+
+void addLevelElement(Level *level, RectangleEnv element)
+{
+    if (level->mapping != NULL) detachLevel(level);
+    if (level->elementsSize >= level->elementsCapacity)
+    {
+        int newCapacity = level->elementsCapacity > 0
+            ? level->elementsCapacity * 2 : 16;
+        RectangleEnv *newElements =
+            realloc(level->elements, sizeof(RectangleEnv) * newCapacity);
+        if (newElements == NULL) return;
+        level->elements = newElements;
+        level->elementsCapacity = newCapacity;
+    }
+    level->elements[level->elementsSize++] = element;
+}
+
+void bakeLevel(Level *level)
+{
+    // Mapped levels were baked when they were saved
+    if (level->mapping != NULL) return;
+
+    unloadLevelGeometry(&level->geometry);
+    level->geometry = buildLevelGeometry(level->elements, level->elementsSize);
+    unloadSpatialGrid(&level->grid);
+    level->grid = buildSpatialGrid(level->elements, level->elementsSize,
+                                   SPATIAL_GRID_DEFAULT_CELL_SIZE);
+    unloadLevelDrawList(&level->drawList);
+    level->drawList = buildLevelDrawList(level->elements, level->elementsSize);
+}
+
+static const char LEVEL_FILE_MAGIC[4] = {'L', 'E', 'V', 'L'};
+
+// Reserves the next section of a level file and returns where it starts
+static size_t takeLevelSection(size_t *offset, size_t bytes)
+{
+    const size_t start = (*offset + LEVEL_FILE_ALIGNMENT - 1)
+                         & ~(size_t)(LEVEL_FILE_ALIGNMENT - 1);
+    *offset = start + bytes;
+    return start;
+}
+
+static bool writeLevelSection(FILE *file, size_t *offset,
+                              const void *data, size_t bytes)
+{
+    static const char padding[LEVEL_FILE_ALIGNMENT] = {0};
+    const size_t start = takeLevelSection(offset, bytes);
+    const size_t paddingSize = start - ftell(file);
+    return fwrite(padding, 1, paddingSize, file) == paddingSize
+        && fwrite(data, 1, bytes, file) == bytes;
+}
+
+// Points at the next section of a mapped level file, or NULL if the file
+// is too short to hold it
+static void *readLevelSection(const unsigned char *data, size_t size,
+                              size_t *offset, size_t bytes)
+{
+    const size_t start = takeLevelSection(offset, bytes);
+    if (start > size || size - start < bytes) return NULL;
+    return (void *)(data + start);
+}
+
+static LevelFileGrid describeGrid(const SpatialGrid *grid)
+{
+    return (LevelFileGrid){
+        .cellSize = grid->cellSize,
+        .bucketsSize = grid->bucketMask + 1,
+        .itemsSize = grid->bucketStarts[grid->bucketMask + 1],
+        .largeItemsSize = grid->largeItemsSize,
+    };
+}
+
+static bool writeGrid(FILE *file, size_t *offset, const SpatialGrid *grid)
+{
+    const LevelFileGrid sizes = describeGrid(grid);
+    return writeLevelSection(file, offset, grid->bucketStarts,
+                             sizeof(int) * (sizes.bucketsSize + 1))
+        && writeLevelSection(file, offset, grid->items,
+                             sizeof(int) * sizes.itemsSize)
+        && writeLevelSection(file, offset, grid->largeItems,
+                             sizeof(int) * sizes.largeItemsSize);
+}
+
+static bool readGrid(const unsigned char *data, size_t size, size_t *offset,
+                     LevelFileGrid sizes, SpatialGrid *grid)
+{
+    // Bucket counts are always powers of 2, see buildSpatialGrid
+    if (sizes.bucketsSize == 0
+     || (sizes.bucketsSize & (sizes.bucketsSize - 1)) != 0) return false;
+
+    *grid = (SpatialGrid){
+        .cellSize = sizes.cellSize,
+        .bucketMask = sizes.bucketsSize - 1,
+        .bucketStarts = readLevelSection(data, size, offset,
+                            sizeof(int) * ((size_t)sizes.bucketsSize + 1)),
+        .items = readLevelSection(data, size, offset,
+                                  sizeof(int) * (size_t)sizes.itemsSize),
+        .largeItems = readLevelSection(data, size, offset,
+                                       sizeof(int) * (size_t)sizes.largeItemsSize),
+        .largeItemsSize = sizes.largeItemsSize,
+    };
+    return grid->bucketStarts != NULL && grid->items != NULL
+        && grid->largeItems != NULL
+        && grid->bucketStarts[sizes.bucketsSize] == (int)sizes.itemsSize;
+}
+
+bool saveLevel(const Level *level, const char *fileName, bool includeGrids)
+{
+    const LevelGeometry *geometry = &level->geometry;
+    if (geometry->x == NULL) return false;
+
+    LevelFileHeader header = {
+        .version = LEVEL_FILE_VERSION,
+        .flags = includeGrids ? LEVEL_FILE_HAS_GRIDS : 0,
+        .elementsSize = level->elementsSize,
+        .geometryPaddedSize = geometry->paddedSize,
+        .drawRectsSize = level->drawList.rectsSize,
+    };
+    memcpy(header.magic, LEVEL_FILE_MAGIC, sizeof(header.magic));
+    if (includeGrids)
+    {
+        header.grid = describeGrid(&level->grid);
+        header.drawGrid = describeGrid(&level->drawList.grid);
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    const size_t floats = sizeof(float) * geometry->paddedSize;
+    size_t offset = 0;
+    bool isOk = writeLevelSection(file, &offset, &header, sizeof(header))
+        && writeLevelSection(file, &offset, level->elements,
+                             sizeof(RectangleEnv) * level->elementsSize)
+        && writeLevelSection(file, &offset, geometry->x, floats)
+        && writeLevelSection(file, &offset, geometry->y, floats)
+        && writeLevelSection(file, &offset, geometry->width, floats)
+        && writeLevelSection(file, &offset, geometry->height, floats)
+        && writeLevelSection(file, &offset, geometry->state,
+                             sizeof(unsigned int) * geometry->paddedSize)
+        && writeLevelSection(file, &offset, level->drawList.rects,
+                             sizeof(RectangleEnv) * level->drawList.rectsSize);
+    if (isOk && includeGrids)
+        isOk = writeGrid(file, &offset, &level->grid)
+            && writeGrid(file, &offset, &level->drawList.grid);
+
+    if (fclose(file) != 0) isOk = false;
+    return isOk;
+}
+
+bool loadLevel(Level *level, const char *fileName)
+{
+    size_t size;
+    const unsigned char *data = mapFile(fileName, &size);
+    if (data == NULL) return false;
+
+    // Only the header and section sizes get checked. The contents are
+    // trusted, since checking them would cost as much as building them.
+    const LevelFileHeader *header = (const LevelFileHeader *)data;
+    if (size < sizeof(LevelFileHeader)
+     || memcmp(header->magic, LEVEL_FILE_MAGIC, sizeof(header->magic)) != 0
+     || header->version != LEVEL_FILE_VERSION
+     || header->geometryPaddedSize % LEVEL_GEOMETRY_BLOCK != 0
+     || header->geometryPaddedSize < header->elementsSize)
+    {
+        unmapFile(data, size);
+        return false;
+    }
+
+    Level loaded = {
+        .elementsSize = header->elementsSize,
+        .mapping = data,
+        .mappingSize = size,
+        .areGridsMapped = (header->flags & LEVEL_FILE_HAS_GRIDS) != 0,
+    };
+    LevelGeometry *geometry = &loaded.geometry;
+    LevelDrawList *drawList = &loaded.drawList;
+    const size_t floats = sizeof(float) * (size_t)header->geometryPaddedSize;
+
+    size_t offset = sizeof(LevelFileHeader);
+    loaded.elements = readLevelSection(data, size, &offset,
+        sizeof(RectangleEnv) * (size_t)header->elementsSize);
+    geometry->x = readLevelSection(data, size, &offset, floats);
+    geometry->y = readLevelSection(data, size, &offset, floats);
+    geometry->width = readLevelSection(data, size, &offset, floats);
+    geometry->height = readLevelSection(data, size, &offset, floats);
+    geometry->state = readLevelSection(data, size, &offset,
+        sizeof(unsigned int) * (size_t)header->geometryPaddedSize);
+    geometry->size = header->elementsSize;
+    geometry->paddedSize = header->geometryPaddedSize;
+    drawList->rects = readLevelSection(data, size, &offset,
+        sizeof(RectangleEnv) * (size_t)header->drawRectsSize);
+    drawList->rectsSize = header->drawRectsSize;
+
+    bool isOk = loaded.elements != NULL && geometry->x != NULL
+        && geometry->y != NULL && geometry->width != NULL
+        && geometry->height != NULL && geometry->state != NULL
+        && drawList->rects != NULL;
+    if (isOk && loaded.areGridsMapped)
+        isOk = readGrid(data, size, &offset, header->grid, &loaded.grid)
+            && readGrid(data, size, &offset, header->drawGrid, &drawList->grid);
+    if (!isOk)
+    {
+        unmapFile(data, size);
+        return false;
+    }
+
+    if (!loaded.areGridsMapped)
+    {
+        loaded.grid = buildSpatialGrid(loaded.elements, loaded.elementsSize,
+                                       SPATIAL_GRID_DEFAULT_CELL_SIZE);
+        drawList->grid = buildSpatialGrid(drawList->rects, drawList->rectsSize,
+                                          SPATIAL_GRID_DEFAULT_CELL_SIZE);
+    }
+    drawList->visibleCapacity = 256;
+    drawList->visible = malloc(sizeof(int) * drawList->visibleCapacity);
+
+    *level = loaded;
+    return true;
+}
+
+LevelGeometry buildLevelGeometry(const RectangleEnv elements[],
+                                 int elementsSize)
+{
+    LevelGeometry geometry = {0};
+    geometry.size = elementsSize;
+    geometry.paddedSize = (elementsSize + LEVEL_GEOMETRY_BLOCK - 1)
+                          / LEVEL_GEOMETRY_BLOCK * LEVEL_GEOMETRY_BLOCK;
+    if (geometry.paddedSize == 0) geometry.paddedSize = LEVEL_GEOMETRY_BLOCK;
+
+    const size_t floats = sizeof(float) * geometry.paddedSize;
+    geometry.x = malloc(floats);
+    geometry.y = malloc(floats);
+    geometry.width = malloc(floats);
+    geometry.height = malloc(floats);
+    geometry.state = malloc(sizeof(unsigned int) * geometry.paddedSize);
+
+    for (int i = 0; i < geometry.paddedSize; i++)
+    {
+        if (i < elementsSize && isPhysical(&elements[i]))
+        {
+            geometry.x[i] = elements[i].rect.x;
+            geometry.y[i] = elements[i].rect.y;
+            geometry.width[i] = elements[i].rect.width;
+            geometry.height[i] = elements[i].rect.height;
+            geometry.state[i] = elements[i].state;
+        }
+        else
+        {
+            // x + width stays FLT_MAX, so nothing finite ever reaches it
+            geometry.x[i] = FLT_MAX;
+            geometry.y[i] = FLT_MAX;
+            geometry.width[i] = 0;
+            geometry.height[i] = 0;
+            geometry.state[i] = 0;
+        }
+    }
+
+    return geometry;
+}
+
+void unloadLevelGeometry(LevelGeometry *geometry)
+{
+    free(geometry->x);
+    free(geometry->y);
+    free(geometry->width);
+    free(geometry->height);
+    free(geometry->state);
+    *geometry = (LevelGeometry){0};
+}
+
+// A visible element waiting to be merged, remembering where it came from
+typedef struct DrawRun
+{
+    RectangleEnv rect;
+    int firstIndex;
+    int lastIndex;
+} DrawRun;
+
+// Most elements checked for being layered in between a merge
+#define DRAW_MERGE_MAX_BETWEEN 256
+
+static unsigned int colorKey(Color color)
+{
+    return (unsigned int)color.r << 24 | (unsigned int)color.g << 16
+         | (unsigned int)color.b << 8 | color.a;
+}
+
+static bool isDrawn(const RectangleEnv *element)
+{
+    return element->rect.width > 0 && element->rect.height > 0
+        && element->color.a > 0;
+}
+
+// Whether run can be drawn at its first element's place without anything
+// of another colour (from between its first and last elements) that should
+// be on top of part of it ending up underneath instead
+static bool isDrawRunLayered(const DrawRun *run, const RectangleEnv elements[],
+                             const SpatialGrid *grid)
+{
+    int between[DRAW_MERGE_MAX_BETWEEN];
+    const int betweenSize = querySpatialGrid(grid, run->rect.rect, between,
+                                             DRAW_MERGE_MAX_BETWEEN);
+    if (betweenSize < 0) return false;
+
+    const Rectangle r = run->rect.rect;
+    for (int i = 0; i < betweenSize; i++)
+    {
+        const int index = between[i];
+        const RectangleEnv *e = &elements[index];
+        if (index <= run->firstIndex || index >= run->lastIndex
+         || !isDrawn(e) || colorKey(e->color) == colorKey(run->rect.color))
+            continue;
+        // Only overlapping area matters, touching edges don't
+        if (e->rect.x < r.x + r.width && e->rect.x + e->rect.width > r.x
+         && e->rect.y < r.y + r.height && e->rect.y + e->rect.height > r.y)
+            return false;
+    }
+    return true;
+}
+
+// Groups runs by colour, then row, then left edge
+static int compareDrawRunRows(const void *a, const void *b)
+{
+    const DrawRun *x = a, *y = b;
+    const unsigned int xc = colorKey(x->rect.color), yc = colorKey(y->rect.color);
+    if (xc != yc) return (xc > yc) - (xc < yc);
+    if (x->rect.rect.y != y->rect.rect.y)
+        return (x->rect.rect.y > y->rect.rect.y) - (x->rect.rect.y < y->rect.rect.y);
+    if (x->rect.rect.height != y->rect.rect.height)
+        return (x->rect.rect.height > y->rect.rect.height)
+             - (x->rect.rect.height < y->rect.rect.height);
+    if (x->rect.rect.x != y->rect.rect.x)
+        return (x->rect.rect.x > y->rect.rect.x) - (x->rect.rect.x < y->rect.rect.x);
+    return (x->firstIndex > y->firstIndex) - (x->firstIndex < y->firstIndex);
+}
+
+static int compareDrawRunOrder(const void *a, const void *b)
+{
+    const DrawRun *x = a, *y = b;
+    return (x->firstIndex > y->firstIndex) - (x->firstIndex < y->firstIndex);
+}
+
+LevelDrawList buildLevelDrawList(const RectangleEnv elements[],
+                                 int elementsSize)
+{
+    LevelDrawList drawList = {0};
+    DrawRun *runs = malloc(sizeof(DrawRun) * (elementsSize > 0 ? elementsSize : 1));
+
+    int runsSize = 0;
+    for (int i = 0; i < elementsSize; i++)
+    {
+        const RectangleEnv *e = &elements[i];
+        if (!isDrawn(e)) continue;
+        runs[runsSize++] = (DrawRun){{e->rect, e->color, 0}, i, i};
+    }
+
+    // Merge each row of same coloured rectangles that touch or overlap.
+    // Only opaque ones, since blending overlaps twice shows, and only where
+    // the merged rectangle can be drawn at its first element's place.
+    SpatialGrid grid = buildSpatialGrid(elements, elementsSize,
+                                        SPATIAL_GRID_DEFAULT_CELL_SIZE);
+    qsort(runs, runsSize, sizeof(DrawRun), compareDrawRunRows);
+    int mergedSize = 0;
+    for (int i = 0; i < runsSize; i++)
+    {
+        DrawRun *last = mergedSize > 0 ? &runs[mergedSize - 1] : NULL;
+        if (last != NULL
+         && last->rect.color.a == 255
+         && colorKey(last->rect.color) == colorKey(runs[i].rect.color)
+         && last->rect.rect.y == runs[i].rect.rect.y
+         && last->rect.rect.height == runs[i].rect.rect.height
+         && runs[i].rect.rect.x <= last->rect.rect.x + last->rect.rect.width)
+        {
+            DrawRun merged = *last;
+            const float right = fmaxf(last->rect.rect.x + last->rect.rect.width,
+                                      runs[i].rect.rect.x + runs[i].rect.rect.width);
+            merged.rect.rect.width = right - last->rect.rect.x;
+            if (runs[i].firstIndex < merged.firstIndex)
+                merged.firstIndex = runs[i].firstIndex;
+            if (runs[i].lastIndex > merged.lastIndex)
+                merged.lastIndex = runs[i].lastIndex;
+            if (isDrawRunLayered(&merged, elements, &grid))
+            {
+                *last = merged;
+                continue;
+            }
+        }
+        runs[mergedSize++] = runs[i];
+    }
+    unloadSpatialGrid(&grid);
+    qsort(runs, mergedSize, sizeof(DrawRun), compareDrawRunOrder);
+
+    drawList.rects = malloc(sizeof(RectangleEnv) * (mergedSize > 0 ? mergedSize : 1));
+    for (int i = 0; i < mergedSize; i++)
+        drawList.rects[i] = runs[i].rect;
+    drawList.rectsSize = mergedSize;
+    free(runs);
+
+    drawList.grid = buildSpatialGrid(drawList.rects, drawList.rectsSize,
+                                     SPATIAL_GRID_DEFAULT_CELL_SIZE);
+    drawList.visibleCapacity = 256;
+    drawList.visible = malloc(sizeof(int) * drawList.visibleCapacity);
+
+    return drawList;
+}
+
+void unloadLevelDrawList(LevelDrawList *drawList)
+{
+    free(drawList->rects);
+    unloadSpatialGrid(&drawList->grid);
+    free(drawList->visible);
+    *drawList = (LevelDrawList){0};
+}
+
+int cullLevelDrawList(LevelDrawList *drawList, Rectangle view)
+{
+    if (drawList->visible == NULL) return 0;
+
+    int visibleSize;
+    while ((visibleSize = querySpatialGrid(&drawList->grid, view,
+                                           drawList->visible,
+                                           drawList->visibleCapacity)) < 0)
+    {
+        int *grown = realloc(drawList->visible,
+                             sizeof(int) * drawList->visibleCapacity * 2);
+        if (grown == NULL) return 0;
+        drawList->visible = grown;
+        drawList->visibleCapacity *= 2;
+    }
+
+    // The grid hands back everything in the touched cells, so trim it to
+    // what's really in view
+    int keptSize = 0;
+    for (int i = 0; i < visibleSize; i++)
+    {
+        const Rectangle rect = drawList->rects[drawList->visible[i]].rect;
+        if (rect.x <= view.x + view.width && rect.x + rect.width >= view.x
+         && rect.y <= view.y + view.height && rect.y + rect.height >= view.y)
+            drawList->visible[keptSize++] = drawList->visible[i];
+    }
+
+    return keptSize;
+}
+
+// Bit j is set if element first + j overlaps [left, right] x [top, bottom]
+static unsigned int overlapBlock(const LevelGeometry *geometry, int first,
+                                 float left, float top,
+                                 float right, float bottom)
+{
+#if defined(__AVX__)
+    const __m256 x = _mm256_loadu_ps(geometry->x + first);
+    const __m256 y = _mm256_loadu_ps(geometry->y + first);
+    const __m256 r = _mm256_add_ps(x, _mm256_loadu_ps(geometry->width + first));
+    const __m256 b = _mm256_add_ps(y, _mm256_loadu_ps(geometry->height + first));
+    __m256 hit = _mm256_and_ps(
+        _mm256_cmp_ps(x, _mm256_set1_ps(right), _CMP_LE_OQ),
+        _mm256_cmp_ps(r, _mm256_set1_ps(left), _CMP_GE_OQ));
+    hit = _mm256_and_ps(hit, _mm256_and_ps(
+        _mm256_cmp_ps(y, _mm256_set1_ps(bottom), _CMP_LE_OQ),
+        _mm256_cmp_ps(b, _mm256_set1_ps(top), _CMP_GE_OQ)));
+    return (unsigned int)_mm256_movemask_ps(hit);
+#elif defined(__SSE__)
+    unsigned int mask = 0;
+    for (int half = 0; half < LEVEL_GEOMETRY_BLOCK; half += 4)
+    {
+        const int i = first + half;
+        const __m128 x = _mm_loadu_ps(geometry->x + i);
+        const __m128 y = _mm_loadu_ps(geometry->y + i);
+        const __m128 r = _mm_add_ps(x, _mm_loadu_ps(geometry->width + i));
+        const __m128 b = _mm_add_ps(y, _mm_loadu_ps(geometry->height + i));
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(x, _mm_set1_ps(right)),
+                                _mm_cmpge_ps(r, _mm_set1_ps(left)));
+        hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(y, _mm_set1_ps(bottom)),
+                                         _mm_cmpge_ps(b, _mm_set1_ps(top))));
+        mask |= (unsigned int)_mm_movemask_ps(hit) << half;
+    }
+    return mask;
+#else
+    unsigned int mask = 0;
+    for (int j = 0; j < LEVEL_GEOMETRY_BLOCK; j++)
+    {
+        const int i = first + j;
+        if (geometry->x[i] <= right
+         && geometry->x[i] + geometry->width[i] >= left
+         && geometry->y[i] <= bottom
+         && geometry->y[i] + geometry->height[i] >= top)
+            mask |= 1u << j;
+    }
+    return mask;
+#endif
+}
+
+int findLevelOverlaps(const LevelGeometry *geometry, Rectangle area,
+                      int results[], int maxResults)
+{
+    const float left = area.x, top = area.y;
+    const float right = area.x + area.width, bottom = area.y + area.height;
+
+    int resultsSize = 0;
+    for (int first = 0; first < geometry->paddedSize;
+         first += LEVEL_GEOMETRY_BLOCK)
+    {
+        unsigned int mask = overlapBlock(geometry, first,
+                                         left, top, right, bottom);
+        while (mask)
+        {
+            if (resultsSize >= maxResults) return -1;
+            results[resultsSize++] = first + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return resultsSize;
+}
+
+SpatialGrid buildSpatialGrid(const RectangleEnv elements[], int elementsSize,
+                             float cellSize)
+{
+    SpatialGrid grid = {0};
+    grid.cellSize = cellSize;
+
+    // Small levels still get plenty of buckets so unrelated cells rarely
+    // share one and hand physics extra candidates
+    unsigned int bucketsSize = SPATIAL_GRID_MIN_BUCKETS;
+    while (bucketsSize < (unsigned int)elementsSize * 2) bucketsSize <<= 1;
+    grid.bucketMask = bucketsSize - 1;
+    grid.bucketStarts = calloc(bucketsSize + 1, sizeof(int));
+    grid.largeItems = malloc(sizeof(int) * (elementsSize > 0 ? elementsSize : 1));
+
+    // First pass counts how many items land in each bucket
+    int itemsSize = 0;
+    for (int i = 0; i < elementsSize; i++)
+    {
+        if (!isIndexed(&elements[i])) continue;
+
+        int minX, minY, maxX, maxY;
+        getCellRange(elements[i].rect, cellSize, &minX, &minY, &maxX, &maxY);
+        long long cells = (long long)(maxX - minX + 1) * (maxY - minY + 1);
+        if (cells > SPATIAL_GRID_MAX_ELEMENT_CELLS)
+        {
+            grid.largeItems[grid.largeItemsSize++] = i;
+            continue;
+        }
+
+        for (int y = minY; y <= maxY; y++)
+            for (int x = minX; x <= maxX; x++)
+            {
+                grid.bucketStarts[hashCell(x, y, grid.bucketMask) + 1]++;
+                itemsSize++;
+            }
+    }
+
+    for (unsigned int b = 0; b < bucketsSize; b++)
+        grid.bucketStarts[b + 1] += grid.bucketStarts[b];
+
+    // Second pass fills the buckets in element order
+    grid.items = malloc(sizeof(int) * (itemsSize > 0 ? itemsSize : 1));
+    int *fill = malloc(sizeof(int) * bucketsSize);
+    for (unsigned int b = 0; b < bucketsSize; b++)
+        fill[b] = grid.bucketStarts[b];
+
+    for (int i = 0, large = 0; i < elementsSize; i++)
+    {
+        if (!isIndexed(&elements[i])) continue;
+        if (large < grid.largeItemsSize && grid.largeItems[large] == i)
+        {
+            large++;
+            continue;
+        }
+
+        int minX, minY, maxX, maxY;
+        getCellRange(elements[i].rect, cellSize, &minX, &minY, &maxX, &maxY);
+        for (int y = minY; y <= maxY; y++)
+            for (int x = minX; x <= maxX; x++)
+                grid.items[fill[hashCell(x, y, grid.bucketMask)]++] = i;
+    }
+    free(fill);
+
+    return grid;
+}
+
+void unloadSpatialGrid(SpatialGrid *grid)
+{
+    free(grid->bucketStarts);
+    free(grid->items);
+    free(grid->largeItems);
+    *grid = (SpatialGrid){0};
+}
+
+// Adds value to an open addressing set of non-negative ints (-1 is empty),
+// returning false if it was already there
+static bool addToIntSet(int set[], unsigned int mask, int value)
+{
+    unsigned int slot = ((unsigned int)value * 2654435761u) & mask;
+    while (set[slot] >= 0)
+    {
+        if (set[slot] == value) return false;
+        slot = (slot + 1) & mask;
+    }
+    set[slot] = value;
+    return true;
+}
+
+int querySpatialGrid(const SpatialGrid *grid, Rectangle area,
+                     int results[], int maxResults)
+{
+    int minX, minY, maxX, maxY;
+    getCellRange(area, grid->cellSize, &minX, &minY, &maxX, &maxY);
+
+    // Elements can sit in several cells (and cells can share buckets), so
+    // repeats only count against maxResults when there are too many items
+    // to collect them all and sort them out after
+    long long itemsSize = grid->largeItemsSize;
+    for (int y = minY; y <= maxY; y++)
+        for (int x = minX; x <= maxX; x++)
+        {
+            const unsigned int bucket = hashCell(x, y, grid->bucketMask);
+            itemsSize += grid->bucketStarts[bucket + 1]
+                       - grid->bucketStarts[bucket];
+        }
+
+    int *set = NULL;
+    unsigned int setMask = 0;
+    if (itemsSize > maxResults)
+    {
+        unsigned int setSize = 16;
+        while (setSize < (unsigned int)maxResults * 2 + 2) setSize <<= 1;
+        set = malloc(sizeof(int) * setSize);
+        if (set == NULL) return -1;
+        memset(set, 0xFF, sizeof(int) * setSize);
+        setMask = setSize - 1;
+    }
+
+    int resultsSize = 0;
+    for (int i = 0; i < grid->largeItemsSize; i++)
+    {
+        if (resultsSize >= maxResults)
+        {
+            free(set);
+            return -1;
+        }
+        results[resultsSize++] = grid->largeItems[i];
+    }
+
+    for (int y = minY; y <= maxY; y++)
+        for (int x = minX; x <= maxX; x++)
+        {
+            const unsigned int bucket = hashCell(x, y, grid->bucketMask);
+            for (int j = grid->bucketStarts[bucket];
+                 j < grid->bucketStarts[bucket + 1]; j++)
+            {
+                const int item = grid->items[j];
+                if (set != NULL && !addToIntSet(set, setMask, item)) continue;
+                if (resultsSize >= maxResults)
+                {
+                    free(set);
+                    return -1;
+                }
+                results[resultsSize++] = item;
+            }
+        }
+    free(set);
+
+    // Back in level order without repeats. Physics resolves collisions in
+    // level order, same as a linear scan would.
+    qsort(results, resultsSize, sizeof(int), compareInts);
+    int uniqueSize = 0;
+    for (int i = 0; i < resultsSize; i++)
+        if (uniqueSize == 0 || results[uniqueSize - 1] != results[i])
+            results[uniqueSize++] = results[i];
+
+    return uniqueSize;
+}
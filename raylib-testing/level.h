@@ -0,0 +1,156 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "include/raylib.h"
+
+typedef struct RectangleEnv
+{
+    Rectangle rect;
+    Color color;
+    unsigned int state;
+} RectangleEnv;
+
+// Static spatial hash over level elements, built once when a level loads.
+// Holds anything that can collide, be a goal or be seen.
+// Cells are hashed into buckets so memory only depends on element count,
+// not on how spread out the level is.
+typedef struct SpatialGrid
+{
+    float cellSize;
+    unsigned int bucketMask;  // bucketsSize - 1, bucketsSize is a power of 2
+    int *bucketStarts;        // bucketsSize + 1 offsets into items
+    int *items;               // Element indices grouped by bucket
+    int *largeItems;          // Elements spanning too many cells to hash
+    int largeItemsSize;
+} SpatialGrid;
+
+// Elements bigger than this many cells go in largeItems instead
+#define SPATIAL_GRID_MAX_ELEMENT_CELLS 64
+#define SPATIAL_GRID_DEFAULT_CELL_SIZE 128.0f
+#define SPATIAL_GRID_MIN_BUCKETS 1024
+
+// Structure-of-arrays copy of the element geometry physics reads, so the
+// collision loop doesn't drag colours through the cache. Entries keep the
+// same indices as Level.elements. Elements that can't collide or be a goal
+// are parked far away so overlap tests never report them, and the arrays
+// are padded to a whole number of SIMD blocks with the same sentinels.
+typedef struct LevelGeometry
+{
+    float *x;
+    float *y;
+    float *width;
+    float *height;
+    unsigned int *state;
+    int size;
+    int paddedSize;           // Multiple of LEVEL_GEOMETRY_BLOCK
+} LevelGeometry;
+
+#define LEVEL_GEOMETRY_BLOCK 8
+
+// Visible elements merged and indexed for drawing. Touching or overlapping
+// opaque rectangles in the same row with the same colour become one
+// rectangle, unless something of another colour layered between them
+// overlaps it. rects stay in level order (by their first element), so
+// culled draws keep the same layering.
+typedef struct LevelDrawList
+{
+    RectangleEnv *rects;
+    int rectsSize;
+    SpatialGrid grid;
+    int *visible;             // Scratch filled by cullLevelDrawList
+    int visibleCapacity;
+} LevelDrawList;
+
+// Growable list of level elements plus the broadphase built over them.
+// Only the first elementsSize entries are live.
+// Levels from loadLevel point straight into their mapped file instead,
+// so their arrays are read only. Changing one copies it first.
+typedef struct Level
+{
+    RectangleEnv *elements;
+    int elementsSize;
+    int elementsCapacity;
+    LevelGeometry geometry;   // Empty until bakeLevel is called
+    SpatialGrid grid;         // Empty until bakeLevel is called
+    LevelDrawList drawList;   // Empty until bakeLevel is called
+    const void *mapping;      // Level file everything points into, if any
+    size_t mappingSize;
+    bool areGridsMapped;      // False if the file's grids were built on load
+} Level;
+
+// Sizes of a SpatialGrid's arrays in a level file
+typedef struct LevelFileGrid
+{
+    float cellSize;
+    uint32_t bucketsSize;
+    uint32_t itemsSize;
+    uint32_t largeItemsSize;
+} LevelFileGrid;
+
+// Start of a level file. After it come the elements, the geometry arrays,
+// the draw list's rects and (with LEVEL_FILE_HAS_GRIDS) both grids' arrays,
+// each starting on a LEVEL_FILE_ALIGNMENT boundary so SIMD loads and
+// cache lines line up once mapped.
+typedef struct LevelFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t elementsSize;
+    uint32_t geometryPaddedSize;
+    uint32_t drawRectsSize;
+    LevelFileGrid grid;
+    LevelFileGrid drawGrid;
+} LevelFileHeader;
+
+#define LEVEL_FILE_VERSION 1
+#define LEVEL_FILE_ALIGNMENT 64
+#define LEVEL_FILE_HAS_GRIDS 1
+
+Level createLevel(int capacity);
+void unloadLevel(Level *level);
+void clearLevel(Level *level);
+void addLevelElement(Level *level, RectangleEnv element);
+// Call after changing elements so physics and drawing see the new layout.
+// Builds the SoA geometry, spatial grid and draw list.
+void bakeLevel(Level *level);
+// Writes a baked level. Leaving the grids out makes the file smaller but
+// has loadLevel build them.
+bool saveLevel(const Level *level, const char *fileName, bool includeGrids);
+// Maps a level file and uses it in place, already baked. Only the grids
+// (if the file has none) and culling scratch get allocated.
+bool loadLevel(Level *level, const char *fileName);
+// Identifies a layout, e.g. so a replay isn't played back on the wrong one.
+// It's the sum of every element's hash with its index, so the same
+// elements in the same order match however they were loaded (worlds
+// included, see hashWorld).
+uint64_t hashLevel(const Level *level);
+uint64_t hashLevelElement(RectangleEnv element, uint32_t index);
+
+LevelGeometry buildLevelGeometry(const RectangleEnv elements[],
+                                 int elementsSize);
+void unloadLevelGeometry(LevelGeometry *geometry);
+// Writes the ascending indices of elements overlapping area (touching
+// edges count). Tests a whole SIMD block of elements per instruction.
+// Returns -1 if there were more than maxResults hits.
+int findLevelOverlaps(const LevelGeometry *geometry, Rectangle area,
+                      int results[], int maxResults);
+
+LevelDrawList buildLevelDrawList(const RectangleEnv elements[],
+                                 int elementsSize);
+void unloadLevelDrawList(LevelDrawList *drawList);
+// Fills drawList->visible with the rects overlapping view, in draw order,
+// and returns how many there are
+int cullLevelDrawList(LevelDrawList *drawList, Rectangle view);
+
+SpatialGrid buildSpatialGrid(const RectangleEnv elements[], int elementsSize,
+                             float cellSize);
+void unloadSpatialGrid(SpatialGrid *grid);
+// Writes the sorted, de-duplicated indices of elements that might overlap
+// area. Returns -1 if there were more than maxResults distinct candidates.
+int querySpatialGrid(const SpatialGrid *grid, Rectangle area,
+                     int results[], int maxResults);
+
+#endif // LEVEL_H
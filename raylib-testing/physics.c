@@ -0,0 +1,404 @@
+#include <math.h>
+#include <stddef.h>
+#include "physics.h"
+
+const float GRAVITY = -9.8;
+const int COLLISION_ALLOWANCE = 5;
+const double PHYSICS_DELTA = 1.0 / 128.0;
+
+const FixedStepPolicy DEFAULT_FIXED_STEP_POLICY = {
+    .maxTicksPerFrame = 16,
+    .maxFrameTime = 0.25,
+    .minTimeScale = 0.25,
+    .timeScaleRecovery = 0.05,
+};
+
+Player getDefaultPlayer(void)
+{
+    return (Player){
+        .rect = {0, 0, 30, 50},
+        .debugColor = (Color){255, 0, 0, 100},
+        .velocity = {0, 0},
+        .acceleration = 300,
+        .jumpStrength = 3.5,
+        .maxBoost = 100,
+        .boostCharge = 0,
+        .boostStrength = 2,
+        .mass = 74,
+        .direction = 1,
+        .currentFrame = 0,
+    };
+}
+
+int findCollisionCandidates(const Level *level, Rectangle area,
+                            int candidates[])
+{
+    const int candidatesSize = level->grid.bucketStarts != NULL
+        ? querySpatialGrid(&level->grid, area,
+                           candidates, PHYSICS_MAX_CANDIDATES)
+        : -1;
+    if (candidatesSize >= 0) return candidatesSize;
+
+    // No grid, or too much of the level is near area for it to narrow
+    // down: the SIMD scan only keeps what actually overlaps
+    return findLevelOverlaps(&level->geometry, area,
+                             candidates, PHYSICS_MAX_CANDIDATES);
+}
+
+// Earliest fraction of the move (dx, dy) at which box starts touching
+// target, or -1 if it doesn't during this move or they already overlap.
+// *isHitX says whether the contact is on the x axis.
+static float sweepBox(Rectangle box, float dx, float dy, Rectangle target,
+                      bool *isHitX)
+{
+    float entryX, exitX, entryY, exitY;
+
+    if (dx > 0)
+    {
+        entryX = (target.x - (box.x + box.width)) / dx;
+        exitX = (target.x + target.width - box.x) / dx;
+    }
+    else if (dx < 0)
+    {
+        entryX = (target.x + target.width - box.x) / dx;
+        exitX = (target.x - (box.x + box.width)) / dx;
+    }
+    else if (box.x < target.x + target.width && box.x + box.width > target.x)
+    {
+        entryX = -INFINITY;
+        exitX = INFINITY;
+    }
+    else return -1;
+
+    if (dy > 0)
+    {
+        entryY = (target.y - (box.y + box.height)) / dy;
+        exitY = (target.y + target.height - box.y) / dy;
+    }
+    else if (dy < 0)
+    {
+        entryY = (target.y + target.height - box.y) / dy;
+        exitY = (target.y - (box.y + box.height)) / dy;
+    }
+    else if (box.y < target.y + target.height && box.y + box.height > target.y)
+    {
+        entryY = -INFINITY;
+        exitY = INFINITY;
+    }
+    else return -1;
+
+    const float entry = fmaxf(entryX, entryY);
+    const float exit = fminf(exitX, exitY);
+    if (entry >= exit || entry < 0 || entry > 1) return -1;
+
+    *isHitX = entryX > entryY;
+    return entry;
+}
+
+// Moves the body by its velocity, stopping at the first solid element in
+// the way and sliding along it with what's left of the move. Nothing is
+// skipped however far it goes in one tick.
+bool moveBody(Body *body, const Level *level)
+{
+    const LevelGeometry *geometry = &level->geometry;
+    Rectangle *rect = &body->rect;
+    float dx = body->velocity.x, dy = body->velocity.y;
+    if (dx == 0 && dy == 0) return false;
+
+    const Rectangle area = {
+        fminf(rect->x, rect->x + dx) - 1, fminf(rect->y, rect->y + dy) - 1,
+        rect->width + fabsf(dx) + 2, rect->height + fabsf(dy) + 2
+    };
+    int candidates[PHYSICS_MAX_CANDIDATES];
+    const int candidatesSize =
+        findCollisionCandidates(level, area, candidates);
+    const int checksSize = candidatesSize >= 0 ? candidatesSize : geometry->size;
+
+    bool isTouchingGoal = false;
+    // Each pass stops one axis, so two is enough. The third catches
+    // anything float rounding leaves over.
+    for (int pass = 0; pass < 3 && (dx != 0 || dy != 0); pass++)
+    {
+        float firstHit = 1;
+        int hitIndex = -1;
+        bool isHitX = false;
+        float goalHit = -1;
+
+        for (int c = 0; c < checksSize; c++)
+        {
+            const int i = candidatesSize >= 0 ? candidates[c] : c;
+            const Rectangle eRect = {
+                geometry->x[i], geometry->y[i],
+                geometry->width[i], geometry->height[i]
+            };
+            bool isX;
+            const float t = sweepBox(*rect, dx, dy, eRect, &isX);
+            if (t < 0) continue;
+
+            if (checkUnsignedIntBit(geometry->state[i], 1)
+             && (goalHit < 0 || t < goalHit))
+                goalHit = t;
+            if (checkUnsignedIntBit(geometry->state[i], 0) && t < firstHit)
+            {
+                firstHit = t;
+                hitIndex = i;
+                isHitX = isX;
+            }
+        }
+        if (goalHit >= 0 && goalHit <= firstHit) isTouchingGoal = true;
+
+        rect->x += dx * firstHit;
+        rect->y += dy * firstHit;
+        if (hitIndex < 0) break;
+
+        // Sit exactly against what was hit so the next tick's ground and
+        // wall checks see the contact
+        if (isHitX)
+        {
+            rect->x = dx > 0 ? geometry->x[hitIndex] - rect->width
+                             : geometry->x[hitIndex] + geometry->width[hitIndex];
+            body->velocity.x = 0;
+            dx = 0;
+            dy *= 1 - firstHit;
+        }
+        else
+        {
+            rect->y = dy > 0 ? geometry->y[hitIndex] - rect->height
+                             : geometry->y[hitIndex] + geometry->height[hitIndex];
+            body->velocity.y = 0;
+            dy = 0;
+            dx *= 1 - firstHit;
+        }
+    }
+
+    return isTouchingGoal;
+}
+
+Contact resolveBodyOverlaps(Body *body, const Level *level)
+{
+    const LevelGeometry *geometry = &level->geometry;
+    Contact contact = {0};
+
+    // Everything the overlap checks below could touch. Padded by the
+    // body's size since resolving one collision can push it that far.
+    const Rectangle r = body->rect;
+    const float padX = fabsf(body->velocity.x) + r.width + 1;
+    const float padY = fabsf(body->velocity.y) + r.height + 1;
+    const Rectangle area = {
+        r.x - padX, r.y - padY, r.width + padX * 2, r.height + padY * 2
+    };
+    int candidates[PHYSICS_MAX_CANDIDATES];
+    const int candidatesSize =
+        findCollisionCandidates(level, area, candidates);
+    const int checksSize = candidatesSize >= 0 ? candidatesSize : geometry->size;
+
+    int pX = body->rect.x, pY = body->rect.y,
+        pH = body->rect.height, pW = body->rect.width;
+    for (int c = 0; c < checksSize; c++)
+    {
+        const int i = candidatesSize >= 0 ? candidates[c] : c;
+        const Rectangle eRect = {
+            geometry->x[i], geometry->y[i],
+            geometry->width[i], geometry->height[i]
+        };
+        if (checkUnsignedIntBit(geometry->state[i], 1)
+         && CheckCollisionRecs(body->rect, eRect))
+        {
+            contact.isTouchingGoal = true;
+        }
+
+        // Check for collidable flag (first bit)
+        if (!checkUnsignedIntBit(geometry->state[i], 0)) continue;
+
+        const int eX = eRect.x, eY = eRect.y,
+                  eW = eRect.width, eH = eRect.height;
+        if (pY + pH > eY + COLLISION_ALLOWANCE
+         && pY < eY + eH - COLLISION_ALLOWANCE)
+        {
+            if (pX + pW > eX + eW && pX < eX + eW)
+            {
+                body->rect.x = eX + eW;
+                contact.hasHitWall = 1;
+                pX = eX + eW;
+                body->velocity.x = 0;
+            }
+            if (pX < eX && pX + pW > eX)
+            {
+                body->rect.x = eX - pW;
+                contact.hasHitWall = 1;
+                pX = eX - pW;
+                body->velocity.x = 0;
+            }
+        }
+        if (pX + pW > eX + COLLISION_ALLOWANCE
+         && pX < eX + eW - COLLISION_ALLOWANCE)
+        {
+            if (pY + pH > eY + eH && pY < eY + eH)
+            {
+                body->rect.y = eY + eH;
+                pY = eY + eH;
+                body->velocity.y = 0;
+            }
+            if (pY <= eY && pY + pH >= eY)
+            {
+                body->rect.y = eY - pH;
+                pY = eY - pH;
+                contact.isOnGround = true;
+                body->velocity.y = 0;
+            }
+        }
+    }
+
+    return contact;
+}
+
+void applyMoverRules(Mover *mover, Body *body, Contact contact,
+                     float deltaTime)
+{
+    const PlayerInput input = mover->input;
+    const bool isOnGround = contact.isOnGround;
+    const int hasHitWall = contact.hasHitWall;
+
+    body->velocity.x *= (isOnGround ? 0.50 : 0.40) * deltaTime;
+    mover->isMoving = false;
+
+    if (isOnGround)
+        mover->boostCharge += 40 * deltaTime;
+    if (mover->boostCharge > mover->maxBoost)
+        mover->boostCharge = mover->maxBoost;
+    if (!isOnGround)
+        body->velocity.y -= GRAVITY * deltaTime;
+    if (input & INPUT_RIGHT) {
+        if (hasHitWall <= 0)
+            body->velocity.x += mover->acceleration * deltaTime;
+        mover->direction = 1;
+        mover->isMoving = true;
+    }
+    if (input & INPUT_LEFT) {
+        if (hasHitWall >= 0)
+            body->velocity.x -= mover->acceleration * deltaTime;
+        mover->direction = 0;
+        mover->isMoving = true;
+    }
+    if ((input & INPUT_JUMP) && isOnGround)
+        body->velocity.y -= mover->jumpStrength;
+    if ((input & INPUT_BOOST)
+     && !isOnGround
+     && (input & (INPUT_LEFT | INPUT_RIGHT))
+     && mover->boostCharge > 0)
+    {
+        mover->boostCharge -= 100 * deltaTime;
+        if (mover->boostCharge < 0)
+            mover->boostCharge = 0;
+        body->velocity.x *= mover->boostStrength;
+    }
+}
+
+void advanceAnimator(Animator *animator, bool isMoving, float deltaTime)
+{
+    // Animation runs off simulated time so replays come out the same
+    animator->timeSinceLastFrame += deltaTime;
+
+    // Increment player animation frames
+    if (isMoving && animator->timeSinceLastFrame >= (1.0 / 30.0))
+    {
+            animator->currentFrame = (animator->currentFrame + 1) % 10;
+            animator->timeSinceLastFrame = 0.0;
+    }
+    if (!isMoving)
+    {
+        animator->currentFrame = 0;
+        animator->timeSinceLastFrame = 0.0;
+    }
+}
+
+// Main game logic
+bool updatePlayer(
+    Player *player, PlayerInput input,
+    const Level *level,
+    float deltaTime)
+{
+    Body body = {player->rect, player->velocity};
+    Mover mover = {
+        .input = input,
+        .acceleration = player->acceleration,
+        .jumpStrength = player->jumpStrength,
+        .maxBoost = player->maxBoost,
+        .boostCharge = player->boostCharge,
+        .boostStrength = player->boostStrength,
+        .direction = player->direction,
+        .isMoving = player->isMoving,
+    };
+    Animator animator = {player->currentFrame, player->timeSinceLastFrame};
+
+    Contact contact = resolveBodyOverlaps(&body, level);
+    applyMoverRules(&mover, &body, contact, deltaTime);
+    if (moveBody(&body, level))
+        contact.isTouchingGoal = true;
+    advanceAnimator(&animator, mover.isMoving, deltaTime);
+
+    player->rect = body.rect;
+    player->velocity = body.velocity;
+    player->boostCharge = mover.boostCharge;
+    player->direction = mover.direction;
+    player->isMoving = mover.isMoving;
+    player->currentFrame = animator.currentFrame;
+    player->timeSinceLastFrame = animator.timeSinceLastFrame;
+
+    return contact.isTouchingGoal;
+}
+
+// FIXED STEP TIMING
+
+FixedStepClock createFixedStepClock(FixedStepPolicy policy)
+{
+    return (FixedStepClock){.policy = policy, .timeScale = 1.0f};
+}
+
+int advanceFixedStepClock(FixedStepClock *clock, double frameDeltaTime)
+{
+    const FixedStepPolicy *policy = &clock->policy;
+
+    // A single huge frame is a stall, not something to simulate through
+    if (frameDeltaTime > policy->maxFrameTime)
+    {
+        clock->droppedTime +=
+            (frameDeltaTime - policy->maxFrameTime) * clock->timeScale;
+        frameDeltaTime = policy->maxFrameTime;
+    }
+    clock->timeToCatchUp += frameDeltaTime * clock->timeScale;
+
+    int ticks = clock->timeToCatchUp / PHYSICS_DELTA;
+    if (ticks > policy->maxTicksPerFrame)
+    {
+        // Falling behind: run the most we're allowed, slow the game down
+        // so next frame asks for less, and drop the rest of the backlog
+        ticks = policy->maxTicksPerFrame;
+        clock->cappedFrames++;
+        clock->timeScale *= 0.5f;
+        if (clock->timeScale < policy->minTimeScale)
+            clock->timeScale = policy->minTimeScale;
+
+        const double leftover = clock->timeToCatchUp - ticks * PHYSICS_DELTA;
+        const double remainder = fmod(leftover, PHYSICS_DELTA);
+        clock->droppedTime += leftover - remainder;
+        clock->timeToCatchUp = ticks * PHYSICS_DELTA + remainder;
+    }
+    else if (ticks <= policy->maxTicksPerFrame / 2 && clock->timeScale < 1.0f)
+    {
+        // Comfortably keeping up again, so ease back to real time
+        clock->timeScale += policy->timeScaleRecovery;
+        if (clock->timeScale > 1.0f) clock->timeScale = 1.0f;
+    }
+
+    clock->timeToCatchUp -= ticks * PHYSICS_DELTA;
+    clock->ticksSize += ticks;
+    return ticks;
+}
+
+// HELPER FUNCTIONS
+
+unsigned int checkUnsignedIntBit(unsigned int item, unsigned int n)
+{
+    return item & (1 << n);
+}
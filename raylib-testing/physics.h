@@ -0,0 +1,137 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include "include/raylib.h"
+#include "level.h"
+
+// TODO: Move to state machine representation
+typedef struct Player
+{
+    Rectangle rect;
+    Color debugColor;
+    Vector2 velocity;
+    float acceleration;
+    float jumpStrength;
+    float maxBoost;
+    float boostCharge;
+    float boostStrength;
+    float mass;
+    int direction;
+    int isMoving;
+    int currentFrame;
+    float timeSinceLastFrame;
+} Player;
+
+// Keys held during a tick, sampled once per rendered frame
+typedef unsigned int PlayerInput;
+
+enum
+{
+    INPUT_RIGHT = 1 << 0,
+    INPUT_LEFT  = 1 << 1,
+    INPUT_JUMP  = 1 << 2,
+    INPUT_BOOST = 1 << 3,
+};
+
+extern const float GRAVITY;
+extern const int COLLISION_ALLOWANCE;
+extern const double PHYSICS_DELTA;
+
+// How the fixed step accumulator copes when frames take too long
+typedef struct FixedStepPolicy
+{
+    int maxTicksPerFrame;     // Ticks past this are put off or dropped
+    double maxFrameTime;      // Longer frames (stalls, window drags) count as this
+    float minTimeScale;       // Slowest the game may run while catching up
+    float timeScaleRecovery;  // How much time scale comes back per calm frame
+} FixedStepPolicy;
+
+// Fixed step accumulator. When the simulation can't keep up it slows game
+// time down (time dilation) instead of running ever more ticks per frame,
+// and throws away whatever still doesn't fit, so frame time stays bounded.
+typedef struct FixedStepClock
+{
+    FixedStepPolicy policy;
+    double timeToCatchUp;
+    float timeScale;          // Game seconds per real second, 1 when healthy
+    double droppedTime;       // Game time never simulated, in seconds
+    long long cappedFrames;   // Frames that hit maxTicksPerFrame
+    long long ticksSize;
+} FixedStepClock;
+
+// Where and how every mode's player starts
+Player getDefaultPlayer(void);
+
+extern const FixedStepPolicy DEFAULT_FIXED_STEP_POLICY;
+
+FixedStepClock createFixedStepClock(FixedStepPolicy policy);
+// Adds a frame's worth of time and returns how many ticks to run for it
+int advanceFixedStepClock(FixedStepClock *clock, double frameDeltaTime);
+
+// Most elements one tick's broadphase query can hand to the narrowphase
+#define PHYSICS_MAX_CANDIDATES 1024
+
+// Indices of every element near area, from the level's grid or, when there
+// is none or it gives too many, a SIMD scan of its geometry. Returns -1 if
+// there are still more than PHYSICS_MAX_CANDIDATES, meaning check every
+// element instead.
+int findCollisionCandidates(const Level *level, Rectangle area,
+                            int candidates[]);
+
+// The pieces of a Player each physics rule works on, so anything that
+// moves like a player (see entities.h) runs the exact same rules
+typedef struct Body
+{
+    Rectangle rect;
+    Vector2 velocity;
+} Body;
+
+typedef struct Mover
+{
+    PlayerInput input;        // Keys held this tick
+    float acceleration;
+    float jumpStrength;
+    float maxBoost;
+    float boostCharge;
+    float boostStrength;
+    int direction;
+    int isMoving;
+} Mover;
+
+typedef struct Animator
+{
+    int currentFrame;
+    float timeSinceLastFrame;
+} Animator;
+
+// What a body touched while its overlaps were resolved
+typedef struct Contact
+{
+    bool isOnGround;
+    bool isTouchingGoal;
+    int hasHitWall;
+} Contact;
+
+// Steps one player by deltaTime. Only touches *player, so it's safe to
+// call from anywhere. Returns true if the player is touching a goal.
+// The level must be baked. Uses its grid if it has one, otherwise scans
+// the whole level's geometry.
+bool updatePlayer(Player *player,
+                  PlayerInput input,
+                  const Level *level,
+                  float deltaTime);
+
+// The steps of updatePlayer, in the order it runs them
+// Pushes body out of anything solid it overlaps
+Contact resolveBodyOverlaps(Body *body, const Level *level);
+// Friction, gravity, walking, jumping and boosting
+void applyMoverRules(Mover *mover, Body *body, Contact contact,
+                     float deltaTime);
+// Sweeps body along its velocity, stopping at solid elements. Returns true
+// if it passed through a goal.
+bool moveBody(Body *body, const Level *level);
+void advanceAnimator(Animator *animator, bool isMoving, float deltaTime);
+
+unsigned int checkUnsignedIntBit(unsigned int item, unsigned int n);
+
+#endif // PHYSICS_H
@@ -0,0 +1,100 @@
+#include <time.h>
+#include "platform.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+int getProcessorCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = (int)info.dwNumberOfProcessors;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count > 0 ? count : 1;
+}
+
+double getWallTime(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void sleepSeconds(double seconds)
+{
+    if (seconds <= 0) return;
+#if defined(_WIN32)
+    // Millisecond granularity, which raylib's timeBeginPeriod(1) makes real
+    Sleep((DWORD)(seconds * 1000.0));
+#else
+    struct timespec duration = {
+        (time_t)seconds, (long)((seconds - (time_t)seconds) * 1e9)
+    };
+    nanosleep(&duration, NULL);
+#endif
+}
+
+const void *mapFile(const char *fileName, size_t *size)
+{
+    *size = 0;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // The view keeps the file open, so the handles can go straight away
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return NULL;
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) return NULL;
+
+    *size = (size_t)fileSize.QuadPart;
+    return data;
+#else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) return NULL;
+
+    *size = (size_t)info.st_size;
+    return data;
+#endif
+}
+
+void unmapFile(const void *data, size_t size)
+{
+    if (data == NULL) return;
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap((void *)data, size);
+#endif
+}
@@ -0,0 +1,20 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stddef.h>
+
+// OS specific bits live in platform.c, which doesn't include raylib.h
+// (windows.h and raylib.h both define things like Rectangle).
+
+// Number of logical processors, at least 1
+int getProcessorCount(void);
+// Maps a whole file read only. Returns NULL (and sets *size to 0) if the
+// file is missing or empty. Undo with unmapFile.
+const void *mapFile(const char *fileName, size_t *size);
+void unmapFile(const void *data, size_t size);
+
+// Seconds since the epoch. Works without a window, unlike GetTime.
+double getWallTime(void);
+void sleepSeconds(double seconds);
+
+#endif // PLATFORM_H
@@ -0,0 +1,154 @@
+#include "profiler.h"
+#include "platform.h"
+
+const char *PROFILE_SECTION_NAMES[PROFILE_SECTIONS_SIZE] = {
+    "input", "physics", "culling", "drawing", "swap"
+};
+
+static const Color PROFILE_SECTION_COLORS[PROFILE_SECTIONS_SIZE] = {
+    {0, 228, 48, 255},        // Green
+    {230, 41, 55, 255},       // Red
+    {253, 249, 0, 255},       // Yellow
+    {0, 121, 241, 255},       // Blue
+    {130, 130, 130, 255},     // Gray
+};
+
+// Frames taller than this are clipped in the overlay
+static const double PROFILER_GRAPH_SECONDS = 1.0 / 30.0;
+
+void beginProfileSection(Profiler *profiler, ProfileSection section)
+{
+    const double now = getWallTime();
+    if (profiler->sectionStart > 0)
+        profiler->current.sections[profiler->currentSection] +=
+            now - profiler->sectionStart;
+    profiler->currentSection = section;
+    profiler->sectionStart = now;
+}
+
+void endProfileFrame(Profiler *profiler, int physicsTicks,
+                     double physicsBacklog)
+{
+    const double now = getWallTime();
+    if (profiler->sectionStart > 0)
+        profiler->current.sections[profiler->currentSection] +=
+            now - profiler->sectionStart;
+    profiler->sectionStart = 0;
+
+    profiler->current.physicsTicks = physicsTicks;
+    profiler->current.physicsBacklog = physicsBacklog;
+
+    if (profiler->csvFile != NULL)
+    {
+        fprintf(profiler->csvFile, "%lld", profiler->frameNumber);
+        for (int i = 0; i < PROFILE_SECTIONS_SIZE; i++)
+            fprintf(profiler->csvFile, ",%.6f",
+                    profiler->current.sections[i] * 1000.0);
+        fprintf(profiler->csvFile, ",%d,%.6f\n",
+                physicsTicks, physicsBacklog * 1000.0);
+    }
+
+    profiler->frames[profiler->nextFrame] = profiler->current;
+    profiler->nextFrame = (profiler->nextFrame + 1) % PROFILER_HISTORY_SIZE;
+    if (profiler->framesSize < PROFILER_HISTORY_SIZE) profiler->framesSize++;
+    profiler->current = (ProfileFrame){0};
+    profiler->frameNumber++;
+}
+
+bool startProfilerCsv(Profiler *profiler, const char *fileName)
+{
+    stopProfilerCsv(profiler);
+    profiler->csvFile = fopen(fileName, "w");
+    if (profiler->csvFile == NULL) return false;
+
+    fprintf(profiler->csvFile, "frame");
+    for (int i = 0; i < PROFILE_SECTIONS_SIZE; i++)
+        fprintf(profiler->csvFile, ",%s_ms", PROFILE_SECTION_NAMES[i]);
+    fprintf(profiler->csvFile, ",physics_ticks,physics_backlog_ms\n");
+    return true;
+}
+
+void stopProfilerCsv(Profiler *profiler)
+{
+    if (profiler->csvFile == NULL) return;
+    fclose(profiler->csvFile);
+    profiler->csvFile = NULL;
+}
+
+void drawProfiler(const Profiler *profiler, int x, int y,
+                  int width, int height)
+{
+    const int fontSize = 10;
+    const int textHeight = (PROFILE_SECTIONS_SIZE + 2) * (fontSize + 2);
+    DrawRectangle(x, y, width, height + textHeight, (Color){0, 0, 0, 180});
+
+    // Averages over the whole history and the worst frame in it
+    double averages[PROFILE_SECTIONS_SIZE] = {0};
+    double worstFrame = 0;
+    int mostTicks = 0;
+    for (int f = 0; f < profiler->framesSize; f++)
+    {
+        const ProfileFrame *frame = &profiler->frames[f];
+        double total = 0;
+        for (int i = 0; i < PROFILE_SECTIONS_SIZE; i++)
+        {
+            averages[i] += frame->sections[i] / profiler->framesSize;
+            total += frame->sections[i];
+        }
+        if (total > worstFrame) worstFrame = total;
+        if (frame->physicsTicks > mostTicks) mostTicks = frame->physicsTicks;
+    }
+
+    int textY = y + 2;
+    for (int i = 0; i < PROFILE_SECTIONS_SIZE; i++)
+    {
+        DrawRectangle(x + 4, textY + 2, 6, 6, PROFILE_SECTION_COLORS[i]);
+        DrawText(TextFormat("%-8s %6.3f ms", PROFILE_SECTION_NAMES[i],
+                            averages[i] * 1000.0),
+                 x + 14, textY, fontSize, RAYWHITE);
+        textY += fontSize + 2;
+    }
+
+    const ProfileFrame *last = profiler->framesSize > 0
+        ? &profiler->frames[(profiler->nextFrame + PROFILER_HISTORY_SIZE - 1)
+                            % PROFILER_HISTORY_SIZE]
+        : &profiler->current;
+    DrawText(TextFormat("worst frame %.2f ms, ticks %d (max %d)",
+                        worstFrame * 1000.0, last->physicsTicks, mostTicks),
+             x + 4, textY, fontSize, RAYWHITE);
+    textY += fontSize + 2;
+    DrawText(TextFormat("backlog %.3f ms%s", last->physicsBacklog * 1000.0,
+                        profiler->csvFile != NULL ? "  [recording csv]" : ""),
+             x + 4, textY, fontSize,
+             profiler->csvFile != NULL ? RED : RAYWHITE);
+
+    // One stacked bar per frame, oldest on the left
+    const int graphY = y + textHeight;
+    const float barWidth = (float)width / PROFILER_HISTORY_SIZE;
+    const int oldest = profiler->framesSize < PROFILER_HISTORY_SIZE
+        ? 0 : profiler->nextFrame;
+    const int firstSlot = PROFILER_HISTORY_SIZE - profiler->framesSize;
+    for (int f = 0; f < profiler->framesSize; f++)
+    {
+        const ProfileFrame *frame =
+            &profiler->frames[(oldest + f) % PROFILER_HISTORY_SIZE];
+        float barBottom = graphY + height;
+        for (int i = 0; i < PROFILE_SECTIONS_SIZE; i++)
+        {
+            float barHeight =
+                frame->sections[i] / PROFILER_GRAPH_SECONDS * height;
+            if (barBottom - barHeight < graphY) barHeight = barBottom - graphY;
+            if (barHeight <= 0) continue;
+            DrawRectangleRec((Rectangle){
+                x + (firstSlot + f) * barWidth, barBottom - barHeight,
+                barWidth, barHeight
+            }, PROFILE_SECTION_COLORS[i]);
+            barBottom -= barHeight;
+        }
+    }
+
+    // 60 FPS budget line
+    const int budgetY = graphY + height
+        - (int)(1.0 / 60.0 / PROFILER_GRAPH_SECONDS * height);
+    DrawLine(x, budgetY, x + width, budgetY, (Color){255, 255, 255, 120});
+}
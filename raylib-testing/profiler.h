@@ -0,0 +1,57 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdio.h>
+#include "include/raylib.h"
+
+// Parts of a frame, in the order the main loop runs them
+typedef enum ProfileSection
+{
+    PROFILE_INPUT,
+    PROFILE_PHYSICS,
+    PROFILE_CULLING,
+    PROFILE_DRAWING,
+    PROFILE_SWAP,             // EndDrawing, which waits on vsync
+    PROFILE_SECTIONS_SIZE
+} ProfileSection;
+
+typedef struct ProfileFrame
+{
+    double sections[PROFILE_SECTIONS_SIZE];  // Seconds spent in each
+    int physicsTicks;
+    double physicsBacklog;    // physicsTimeToCatchUp left after the frame
+} ProfileFrame;
+
+#define PROFILER_HISTORY_SIZE 240
+
+// Rolling history of the last PROFILER_HISTORY_SIZE frames, optionally
+// streamed to a CSV file as they finish
+typedef struct Profiler
+{
+    ProfileFrame frames[PROFILER_HISTORY_SIZE];
+    int framesSize;
+    int nextFrame;
+    ProfileFrame current;
+    ProfileSection currentSection;
+    double sectionStart;
+    long long frameNumber;
+    FILE *csvFile;
+} Profiler;
+
+extern const char *PROFILE_SECTION_NAMES[PROFILE_SECTIONS_SIZE];
+
+// Starts timing a section, ending whichever one was running
+void beginProfileSection(Profiler *profiler, ProfileSection section);
+// Ends the running section and files the frame away
+void endProfileFrame(Profiler *profiler, int physicsTicks,
+                     double physicsBacklog);
+
+bool startProfilerCsv(Profiler *profiler, const char *fileName);
+void stopProfilerCsv(Profiler *profiler);
+
+// Stacked bar per frame (newest on the right) with averages and worst
+// frame listed above it
+void drawProfiler(const Profiler *profiler, int x, int y,
+                  int width, int height);
+
+#endif // PROFILER_H
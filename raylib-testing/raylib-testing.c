@@ -1,7 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "include/raylib.h"
 #include "include/raymath.h"
+#include "physics.h"
+#include "replay.h"
+#include "batch.h"
+#include "platform.h"
+#include "profiler.h"
+#include "sprites.h"
+#include "assets.h"
+#include "world.h"
+#include "entities.h"
+#include "fixed.h"
+#include "sim.h"
 
 typedef struct Window
 {
@@ -9,43 +21,40 @@ typedef struct Window
     unsigned int height;
 } Window;
 
-// TODO: Move to state machine representation
-typedef struct Player
+// Everything a physics tick changes, so ticks can run in the main loop or
+// on a SimThread
+typedef struct GameState
 {
-    Rectangle rect;
-    Color debugColor;
-    Vector2 velocity;
-    float acceleration;
-    float jumpStrength;
-    float maxBoost;
-    float boostCharge;
-    float boostStrength;
-    float mass;
-    int direction;
-    int isMoving;
-    int currentFrame;
-    float timeSinceLastFrame;
-} Player;
-
-typedef struct RectangleEnv
-{
-    Rectangle rect;
-    Color color;
-    unsigned int state;
-} RectangleEnv;
+    Player player;
+    FixedPlayer fixedPlayer;  // Used instead of player's physics with --fixed
+    Camera2D camera;
+    // As of the tick before last, so drawing can blend between the last
+    // two ticks instead of snapping to whichever one ran last
+    Rectangle previousPlayerRect;
+    Vector2 previousCameraTarget;
+    bool goalReached;
+    const Level *level;
+    Replay *replay;           // Every tick gets recorded here, if set
+} GameState;
 
 void printVec2(Vector2 rec);
 void printRec(Rectangle rec);
 Vector2 getTarget(Camera2D camera, Player player);
-unsigned int checkUnsignedIntBit(unsigned int item, unsigned int n);
-void updatePlayer(Player *player,
-                  const RectangleEnv elements[],
-                  int elementsSize,
-                  float deltaTime);
-
-const float GRAVITY = -9.8;
-const int COLLISION_ALLOWANCE = 5;
-const double PHYSICS_DELTA = 1.0 / 128.0;
+Rectangle getCameraView(Camera2D camera, Window window);
+Rectangle lerpRectangle(Rectangle start, Rectangle end, float amount);
+void loadDefaultLevel(Level *level, Window window);
+void addStressPlatforms(Level *level, int platformsSize);
+bool loadGameLevel(Level *level, WorldStream **world, Window window);
+int runHeadless(int argc, char *argv[]);
+int runReplay(int argc, char *argv[]);
+int runBatch(int argc, char *argv[]);
+int runEntities(int argc, char *argv[]);
+int runBakeAssets(void);
+int runSaveLevel(int argc, char *argv[]);
+int runSaveWorld(int argc, char *argv[]);
+PlayerInput readPlayerInput(void);
+void tickGame(void *state, PlayerInput input);
+void resetGameState(void *state);
 
 bool isChangingFrames = false;
 bool goalReached = false;
@@ -53,10 +62,101 @@ bool isDebugging = false;
 bool resetGame = true;
 int maxFPS = 144;
 
-int main(void)
+const Window DEFAULT_WINDOW = {1280, 720};
+
+// Set by --level or --world, otherwise every mode plays the default layout
+const char *levelFileName = NULL;
+const char *worldFileName = NULL;
+// Set by --fixed: physics runs in fixed point so results match bit for
+// bit on any build or machine
+bool isFixedPhysics = false;
+// Set by --sim-thread: the game ticks on its own thread instead of
+// between frames
+bool isSimThreaded = false;
+
+// Sprite sheets the game loads, at the size it draws them
+typedef struct SpriteSheetAsset
 {
+    const char *fileName;
+    int width;                // 0 keeps the file's size
+    int height;
+    int columns;
+    int rows;
+} SpriteSheetAsset;
+
+enum { SHEET_SKELETON, SHEET_BACKGROUND, SHEETS_SIZE };
+
+const SpriteSheetAsset SPRITE_SHEETS[SHEETS_SIZE] = {
+    [SHEET_SKELETON] = {"resources/skeleton.png", 500, 250, 10, 5},
+    [SHEET_BACKGROUND] = {"resources/space.png", 0, 0, 1, 1},
+};
+
+int main(int argc, char *argv[])
+{
+    // Options that go in front of any mode below: --level file.lvl plays
+    // a saved level, --world file.wld streams one in around the player,
+    // --fixed switches to fixed point physics and --sim-thread runs the
+    // game's ticks on their own thread
+    while (argc > 1)
+    {
+        int optionSize = 2;
+        if (argc > 2 && strcmp(argv[1], "--level") == 0)
+            levelFileName = argv[2];
+        else if (argc > 2 && strcmp(argv[1], "--world") == 0)
+            worldFileName = argv[2];
+        else if (strcmp(argv[1], "--fixed") == 0)
+        {
+            isFixedPhysics = true;
+            optionSize = 1;
+        }
+        else if (strcmp(argv[1], "--sim-thread") == 0)
+        {
+            isSimThreaded = true;
+            optionSize = 1;
+        }
+        else break;
+
+        argv[optionSize] = argv[0];
+        argc -= optionSize;
+        argv += optionSize;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--headless") == 0)
+        return runHeadless(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0)
+        return runReplay(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
+        return runBatch(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--entities") == 0)
+        return runEntities(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--bake-assets") == 0)
+        return runBakeAssets();
+    if (argc > 1 && strcmp(argv[1], "--save-level") == 0)
+        return runSaveLevel(argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "--save-world") == 0)
+        return runSaveWorld(argc - 2, argv + 2);
+
+    // game.exe --record session.rpl saves every tick's input on exit
+    const char *recordFileName = NULL;
+    if (argc > 2 && strcmp(argv[1], "--record") == 0)
+        recordFileName = argv[2];
+    Replay replay = {0};
+
     // Initializing variables
-    const Window window = {1280, 720};
+    const Window window = DEFAULT_WINDOW;
+    Level level;
+    WorldStream *world = NULL;
+    if (!loadGameLevel(&level, &world, window)) return EXIT_FAILURE;
+    Level *activeLevel = world != NULL ? world->level : &level;
+    replay.levelHash = world != NULL ? hashWorld(world) : hashLevel(&level);
+    replay.isFixed = isFixedPhysics;
+    // The renderer would be drawing levels the sim thread swaps out
+    if (world != NULL && isSimThreaded)
+    {
+        fprintf(stderr, "--sim-thread doesn't work with --world\n");
+        unloadWorldStream(world);
+        return EXIT_FAILURE;
+    }
     Color backgroundColor = BLACK;
 
     if (!isChangingFrames) { SetConfigFlags(FLAG_VSYNC_HINT); }
@@ -71,141 +171,182 @@ int main(void)
         GetFontDefault().baseSize
     );
 
-    Image skeletonImage = LoadImage("resources/skeleton.png");
-    ImageResize(&skeletonImage, 500, 250);
-    UnloadImage(skeletonImage);
-
-    const Texture2D skeletonSpritesheet = LoadTextureFromImage(skeletonImage);
-    const Texture2D backgroundTexture = LoadTexture("./resources/space.png");
-
-    const int skeletonWidth = skeletonSpritesheet.width / 10;
-    const int skeletonHeight = skeletonSpritesheet.height / 5;
-
-    Player defaultPlayer = {
-        .rect = {0, 0, 30, 50},
-        .debugColor = (Color){255, 0, 0, 100},
-        .velocity = {0, 0},
-        .acceleration = 300,
-        .jumpStrength = 3.5,
-        .maxBoost = 100,
-        .boostCharge = 0,
-        .boostStrength = 2,
-        .mass = 74,
-        .direction = 1,
-        .currentFrame = 0,
-    };
-
-    Player player;
-    player = defaultPlayer;
+    // Every sprite sheet goes in one atlas so drawing never swaps textures.
+    // Images load in the background and show up in it as they finish.
+    SpriteAtlas atlas = createSpriteAtlas(2048, 1024);
+    AssetLoader *assets = createAssetLoader(0);
+    int sheetAssets[SHEETS_SIZE];
+    for (int i = 0; i < SHEETS_SIZE; i++)
+        sheetAssets[i] = requestSpriteSheet(
+            assets, SPRITE_SHEETS[i].fileName,
+            SPRITE_SHEETS[i].width, SPRITE_SHEETS[i].height,
+            SPRITE_SHEETS[i].columns, SPRITE_SHEETS[i].rows);
 
-    RectangleEnv defaultElements[] = {
-        {{-10000, window.height * 2, 20000, 100}, GRAY, 1},
-        {{0, window.height / 2, window.width, 100}, GRAY, 1},
-        {{500, 0, 100, window.height}, GRAY, 1},
-        {{450, 300, 50, 10}, GRAY, 1},
-        {{200, 250, 50, 10}, GRAY, 1},
-        {{195, 205, 10, 50}, GRAY, 1},
-        {{300, 160, 50, 10}, GRAY, 1},
-        {{100, 100, 100, 10}, GRAY, 1},
-        {{450, 50, 50, 10}, GRAY, 1},
+    // Screen space sprites behind everything, then world space sprites
+    SpriteBatch backgroundLayer = {0};
+    SpriteBatch worldLayer = {0};
 
-        {{525, -100, 50, 50}, GREEN, 2},
+    GameState game = {
+        .camera = {
+            .offset = {window.width / 2.0f, window.height / 2.0f},
+            .rotation = 0.0f,
+            .zoom = 1.0f,
+        },
+        .level = activeLevel,
+        .replay = recordFileName != NULL ? &replay : NULL,
     };
-    const int defaultElementsSize =
-        sizeof(defaultElements) / sizeof(defaultElements[0]);
-
-    RectangleEnv elements[255];
-    int elementsSize = sizeof(elements) / sizeof(elements[0]);
+    resetGameState(&game);
 
-    Camera2D camera = {0};
-    camera.target = getTarget(camera, player);
-    camera.offset = (Vector2){window.width / 2.0f, window.height / 2.0f};
-    camera.rotation = 0.0f;
-    camera.zoom = 1.0f;
-
-    double physicsTotalTimeElapsed = 0.0;
     double frameTotalTitleElapsed = 0.0;
-    double physicsTimeToCatchUp = 0.0;
+    FixedStepClock physicsClock =
+        createFixedStepClock(DEFAULT_FIXED_STEP_POLICY);
+    // From here on the sim thread owns game, and frames draw its snapshots
+    SimThread *sim = isSimThreaded
+        ? createSimThread(&game, sizeof(game), tickGame, resetGameState,
+                          DEFAULT_FIXED_STEP_POLICY)
+        : NULL;
+    long long lastSimTicksSize = 0;
+
+    // F3 shows it, F4 starts/stops writing it to profile.csv
+    static Profiler profiler = {0};
 
     // Main game loop
     while (!WindowShouldClose())
     {
+        beginProfileSection(&profiler, PROFILE_INPUT);
+
         // Timing Logic (Fixed Physics Update with varied rendering FPS)
         float frameDeltaTime = GetFrameTime();
-        physicsTimeToCatchUp += frameDeltaTime;
         frameTotalTitleElapsed += frameDeltaTime;
-        player.timeSinceLastFrame += frameDeltaTime;
-        while (physicsTimeToCatchUp >= PHYSICS_DELTA)
-        {
-            camera.target = getTarget(camera, player);
-            updatePlayer(&player, elements, elementsSize, PHYSICS_DELTA);
+        const PlayerInput input = readPlayerInput();
 
-            physicsTimeToCatchUp -= PHYSICS_DELTA;
-            physicsTotalTimeElapsed += PHYSICS_DELTA;
+        beginProfileSection(&profiler, PROFILE_PHYSICS);
+        const GameState *view;    // What this frame draws
+        int physicsTicks;
+        float tickProgress;
+        if (sim != NULL)
+        {
+            // Never waits: takes whatever the sim thread published last
+            setSimInput(sim, input);
+            SimSnapshotInfo info;
+            view = readSimSnapshot(sim, &info);
+            physicsClock = info.clock;    // Only for the overlay and profiler
+            physicsTicks = info.clock.ticksSize - lastSimTicksSize;
+            lastSimTicksSize = info.clock.ticksSize;
+            tickProgress = (info.clock.timeToCatchUp
+                            + (getWallTime() - info.time) * info.clock.timeScale)
+                           / PHYSICS_DELTA;
+        }
+        else
+        {
+            // Picks up chunks a worker finished loading around the camera
+            if (world != NULL)
+            {
+                updateWorldStream(world, game.camera.target);
+                activeLevel = world->level;
+                game.level = activeLevel;
+            }
+            physicsTicks = advanceFixedStepClock(&physicsClock, frameDeltaTime);
+            for (int tick = 0; tick < physicsTicks; tick++)
+                tickGame(&game, input);
+            view = &game;
+            tickProgress = physicsClock.timeToCatchUp / PHYSICS_DELTA;
         }
 
         // Go back to original game state when resetting
         if (resetGame)
         {
             isChangingFrames = false;
-            goalReached = false;
             maxFPS = 144;
 
-            player = defaultPlayer;
-            for (int i = 0; i < defaultElementsSize; i++)
-                elements[i] = *(defaultElements + i);
-            for (int i = defaultElementsSize; i < elementsSize; i++)
-                elements[i] = (RectangleEnv){0};
+            if (sim != NULL) requestSimReset(sim);
+            else resetGameState(&game);
 
             resetGame = false;
         }
 
         // Debugging
+        beginProfileSection(&profiler, PROFILE_INPUT);
         if (IsKeyPressed(KEY_R)) { resetGame = true; }
         if (IsKeyPressed(KEY_F3)) { isDebugging = !isDebugging; }
+        if (IsKeyPressed(KEY_F4))
+        {
+            if (profiler.csvFile != NULL) stopProfilerCsv(&profiler);
+            else if (!startProfilerCsv(&profiler, "profile.csv"))
+                fprintf(stderr, "Couldn't open profile.csv\n");
+        }
         if (isChangingFrames) {
             SetTargetFPS(maxFPS);
             if (IsKeyPressed(KEY_EQUAL)) { maxFPS += 20; }
             if (IsKeyPressed(KEY_MINUS)) { maxFPS -= 20; }
         }
 
+        // Draw where things are partway to the next tick
+        if (tickProgress > 1.0f) tickProgress = 1.0f;
+        const Player player = view->player;
+        const Rectangle playerRect =
+            lerpRectangle(view->previousPlayerRect, player.rect, tickProgress);
+        Camera2D drawCamera = view->camera;
+        drawCamera.target = Vector2Lerp(view->previousCameraTarget,
+                                        view->camera.target, tickProgress);
+
+        // Only what the camera can see gets drawn
+        beginProfileSection(&profiler, PROFILE_CULLING);
+        const int visibleSize = cullLevelDrawList(
+            &activeLevel->drawList, getCameraView(drawCamera, window));
+
+        beginProfileSection(&profiler, PROFILE_DRAWING);
+        uploadLoadedAssets(assets, &atlas);
+        const int skeletonSheet =
+            getAssetSheet(assets, sheetAssets[SHEET_SKELETON]);
+        const int backgroundSheet =
+            getAssetSheet(assets, sheetAssets[SHEET_BACKGROUND]);
+        const int skeletonWidth =
+            getSpriteFrame(&atlas, skeletonSheet, 0, 0).width;
+
         BeginDrawing();
         {
             ClearBackground(backgroundColor);
-            DrawTexture(backgroundTexture, 0, 0, WHITE);
+            addSprite(&backgroundLayer,
+                      getSpriteFrame(&atlas, backgroundSheet, 0, 0),
+                      (Vector2){0, 0}, false, WHITE);
+            drawSpriteBatch(&backgroundLayer, &atlas);
 
-            BeginMode2D(camera);
+            BeginMode2D(drawCamera);
             {
-                // Draw Environment
-                for (int i = 0; i < elementsSize; i++)
+                // Draw Environment. These are back to back untextured
+                // shapes, so raylib keeps them all in one vertex batch.
+                for (int i = 0; i < visibleSize; i++)
                 {
-                    DrawRectangleRec(elements[i].rect, elements[i].color);
+                    const LevelDrawList *drawList = &activeLevel->drawList;
+                    const RectangleEnv *rect =
+                        &drawList->rects[drawList->visible[i]];
+                    DrawRectangleRec(rect->rect, rect->color);
                 }
 
-                // Draw Player
-                DrawTextureRec(
-                    skeletonSpritesheet,
-                    (Rectangle)
-                    {
-                        skeletonWidth * player.currentFrame,
-                        skeletonHeight * 2,
-                        skeletonWidth * (player.direction ? 1 : -1),
-                        skeletonHeight
-                    },
-                    (Vector2)
-                    {
-                        player.rect.x + (player.rect.width - skeletonWidth) / 2,
-                        player.rect.y
-                    },
-                    WHITE);
+                // Draw Player (just its hitbox until the sprite loads)
+                if (skeletonSheet < 0)
+                    DrawRectangleRec(playerRect, player.debugColor);
+                addSprite(&worldLayer,
+                          getSpriteFrame(&atlas, skeletonSheet,
+                                         player.currentFrame, 2),
+                          (Vector2)
+                          {
+                              playerRect.x
+                                  + (playerRect.width - skeletonWidth) / 2,
+                              playerRect.y
+                          },
+                          !player.direction, WHITE);
+                drawSpriteBatch(&worldLayer, &atlas);
+
                 // Player Hitbox
                 if (isDebugging)
-                    DrawRectangleRec(player.rect, player.debugColor);
+                    DrawRectangleRec(playerRect, player.debugColor);
             }
             EndMode2D();
 
             // Draw the win message
-            if (goalReached)
+            if (view->goalReached)
             {
                 DrawText(winMessage,
                         (window.width - winMessageSize.x) / 2,
@@ -221,134 +362,637 @@ int main(void)
             DrawText(boostChargeText, 25, window.height - 50, 25, BLUE);
 
             // More Debugging
-            if (isDebugging) DrawFPS(0, 0);
+            if (isDebugging)
+            {
+                DrawFPS(0, 0);
+                drawProfiler(&profiler, window.width - 250, 0, 250, 100);
+                DrawText(TextFormat("time scale %.2f, dropped %.2f s, "
+                                    "capped frames %lld",
+                                    physicsClock.timeScale,
+                                    physicsClock.droppedTime,
+                                    physicsClock.cappedFrames),
+                         0, 20, 10, RAYWHITE);
+            }
         }
+        beginProfileSection(&profiler, PROFILE_SWAP);
         EndDrawing();
+        endProfileFrame(&profiler, physicsTicks, physicsClock.timeToCatchUp);
     }
 
-    UnloadTexture(backgroundTexture);
-    UnloadTexture(skeletonSpritesheet);
+    // Joining hands the final state (and any recorded replay) back
+    if (sim != NULL) unloadSimThread(sim, &game);
+
+    stopProfilerCsv(&profiler);
+
+    unloadSpriteBatch(&backgroundLayer);
+    unloadSpriteBatch(&worldLayer);
+    unloadAssetLoader(assets);
+    unloadSpriteAtlas(&atlas);
+    if (world != NULL) unloadWorldStream(world);
+    else unloadLevel(&level);
     CloseWindow();
 
+    if (recordFileName != NULL)
+    {
+        if (!saveReplay(&replay, recordFileName))
+            fprintf(stderr, "Couldn't save replay to %s\n", recordFileName);
+        unloadReplay(&replay);
+    }
+
     return EXIT_SUCCESS;
 }
 
-// Main game logic
-void updatePlayer(
-    Player *player,
-    const RectangleEnv elements[], int elementsSize,
-    float deltaTime)
+// HEADLESS SIMULATION
+
+// One line of an input script: hold `keys` for `ticks` physics steps
+typedef struct ScriptStep
+{
+    int ticks;
+    PlayerInput keys;
+} ScriptStep;
+
+// Used when no script file is given. Runs right, jumps, boosts and
+// comes back so every branch of updatePlayer gets exercised.
+const ScriptStep DEFAULT_SCRIPT[] = {
+    {128, INPUT_RIGHT},
+    {4, INPUT_RIGHT | INPUT_JUMP},
+    {32, INPUT_RIGHT | INPUT_BOOST},
+    {64, 0},
+    {128, INPUT_LEFT},
+    {4, INPUT_LEFT | INPUT_JUMP},
+    {32, INPUT_LEFT | INPUT_BOOST},
+    {64, 0},
+};
+
+// Script files have one "<ticks> <keys>" pair per line, where keys is
+// made up of A, D, W and B (boost/space), or "-" for nothing held. Steps
+// that don't last at least a tick are skipped.
+int loadScript(const char *fileName, ScriptStep steps[], int maxSteps)
 {
-    bool isOnGround = false;
-    int hasHitWall = 0;
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return -1;
 
-    int pX = player->rect.x, pY = player->rect.y,
-        pH = player->rect.height, pW = player->rect.width;
-    for (int i = 0; i < elementsSize; i++)
+    int stepsSize = 0;
+    int ticks;
+    char keys[16];
+    while (stepsSize < maxSteps
+        && fscanf(file, "%d %15s", &ticks, keys) == 2)
     {
-        if (checkUnsignedIntBit(elements[i].state, 1)
-         && CheckCollisionRecs(player->rect, elements[i].rect))
+        if (ticks <= 0) continue;
+        PlayerInput mask = 0;
+        for (char *c = keys; *c; c++)
         {
-            goalReached = true;
+            if (*c == 'D' || *c == 'd') mask |= INPUT_RIGHT;
+            if (*c == 'A' || *c == 'a') mask |= INPUT_LEFT;
+            if (*c == 'W' || *c == 'w') mask |= INPUT_JUMP;
+            if (*c == 'B' || *c == 'b') mask |= INPUT_BOOST;
         }
+        steps[stepsSize++] = (ScriptStep){ticks, mask};
+    }
 
-        // Check for collidable flag (first bit)
-        if (!checkUnsignedIntBit(elements[i].state, 0)) continue;
+    fclose(file);
+    return stepsSize;
+}
 
-        const int eX = elements[i].rect.x, eY = elements[i].rect.y,
-                  eW = elements[i].rect.width, eH = elements[i].rect.height;
-        if (pY + pH > eY + COLLISION_ALLOWANCE
-         && pY < eY + eH - COLLISION_ALLOWANCE)
+// Usage: game.exe --headless [ticks] [script.txt]
+// Steps the same fixed physics as the windowed game as fast as the CPU
+// allows, with no window or GL context, looping the script until done.
+int runHeadless(int argc, char *argv[])
+{
+    long long totalTicks = argc > 0 ? atoll(argv[0]) : 1000000;
+
+    static ScriptStep script[4096];
+    int scriptSize = 0;
+    if (argc > 1)
+    {
+        scriptSize = loadScript(argv[1], script, 4096);
+        if (scriptSize < 0)
         {
-            if (pX + pW > eX + eW && pX < eX + eW)
-            {
-                player->rect.x = eX + eW;
-                hasHitWall = 1;
-                pX = eX + eW;
-                player->velocity.x = 0;
-            }
-            if (pX < eX && pX + pW > eX)
-            {
-                player->rect.x = eX - pW;
-                hasHitWall = 1;
-                pX = eX - pW;
-                player->velocity.x = 0;
-            }
+            fprintf(stderr, "Couldn't read input script %s\n", argv[1]);
+            return EXIT_FAILURE;
         }
-        if (pX + pW > eX + COLLISION_ALLOWANCE
-         && pX < eX + eW - COLLISION_ALLOWANCE)
+        if (scriptSize == 0)
         {
-            if (pY + pH > eY + eH && pY < eY + eH)
-            {
-                player->rect.y = eY + eH;
-                pY = eY + eH;
-                player->velocity.y = 0;
-            }
-            if (pY <= eY && pY + pH >= eY)
-            {
-                player->rect.y = eY - pH;
-                pY = eY - pH;
-                isOnGround = true;
-                player->velocity.y = 0;
-            }
+            fprintf(stderr, "Input script %s has no steps with a positive "
+                    "tick count\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        scriptSize = sizeof(DEFAULT_SCRIPT) / sizeof(DEFAULT_SCRIPT[0]);
+        memcpy(script, DEFAULT_SCRIPT, sizeof(DEFAULT_SCRIPT));
+    }
+
+    Player player = getDefaultPlayer();
+    FixedPlayer fixedPlayer = createFixedPlayer(player);
+    Level level;
+    WorldStream *world = NULL;
+    if (!loadGameLevel(&level, &world, DEFAULT_WINDOW)) return EXIT_FAILURE;
+    // Running far faster than real time would outrun background rebuilds
+    if (world != NULL) world->isBlocking = true;
+    Level *activeLevel = world != NULL ? world->level : &level;
+
+    int scriptIndex = 0;
+    int scriptTicksLeft = script[0].ticks;
+    double startTime = getWallTime();
+    for (long long tick = 0; tick < totalTicks; tick++)
+    {
+        while (scriptTicksLeft <= 0)
+        {
+            scriptIndex = (scriptIndex + 1) % scriptSize;
+            scriptTicksLeft = script[scriptIndex].ticks;
+        }
+        const PlayerInput input = script[scriptIndex].keys;
+        scriptTicksLeft--;
+
+        if (world != NULL)
+        {
+            const Vector2 center = isFixedPhysics
+                ? (Vector2){fixedToFloat(fixedPlayer.rect.x),
+                            fixedToFloat(fixedPlayer.rect.y)}
+                : (Vector2){player.rect.x, player.rect.y};
+            updateWorldStream(world, center);
+            activeLevel = world->level;
+        }
+        if (isFixedPhysics)
+        {
+            if (updateFixedPlayer(&fixedPlayer, input, activeLevel))
+                goalReached = true;
+        }
+        else if (updatePlayer(&player, input, activeLevel, PHYSICS_DELTA))
+            goalReached = true;
+    }
+    double elapsed = getWallTime() - startTime;
+    if (isFixedPhysics) applyFixedPlayer(&player, &fixedPlayer);
+
+    printf("Simulated %lld ticks (%.2f s of game time) in %.3f s\n",
+           totalTicks, totalTicks * PHYSICS_DELTA, elapsed);
+    printf("Steps per second: %.0f\n",
+           elapsed > 0 ? totalTicks / elapsed : 0.0);
+    printf("Final player: ");
+    printRec(player.rect);
+    printf("Goal reached: %s\n", goalReached ? "yes" : "no");
+    if (isFixedPhysics)
+        printf("State hash: %016llx\n",
+               (unsigned long long)hashFixedPlayer(&fixedPlayer));
+
+    if (world != NULL) unloadWorldStream(world);
+    else unloadLevel(&level);
+    return EXIT_SUCCESS;
+}
+
+// Usage: game.exe --replay session.rpl [tick]
+// Re-simulates a recorded session as fast as the CPU allows, then seeks
+// to tick (if given) using the snapshots taken along the way.
+int runReplay(int argc, char *argv[])
+{
+    if (argc < 1)
+    {
+        fprintf(stderr, "Usage: --replay session.rpl [tick]\n");
+        return EXIT_FAILURE;
+    }
+
+    Replay replay;
+    if (!loadReplay(&replay, argv[0]))
+    {
+        fprintf(stderr, "Couldn't read replay %s\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Level level;
+    WorldStream *world = NULL;
+    if (!loadGameLevel(&level, &world, DEFAULT_WINDOW))
+    {
+        unloadReplay(&replay);
+        return EXIT_FAILURE;
+    }
+    // Playing back is far faster than real time, so no background loading
+    if (world != NULL) world->isBlocking = true;
+
+    // Anything else would quietly play out differently
+    const uint64_t levelHash = world != NULL ? hashWorld(world)
+                                             : hashLevel(&level);
+    const char *mismatch = NULL;
+    if (replay.levelHash != levelHash)
+        mismatch = "was recorded on a different level (pick it with "
+                   "--level or --world)";
+    else if (replay.isFixed != isFixedPhysics)
+        mismatch = replay.isFixed ? "was recorded with --fixed"
+                                  : "wasn't recorded with --fixed";
+    if (mismatch != NULL)
+    {
+        fprintf(stderr, "Replay %s %s\n", argv[0], mismatch);
+        if (world != NULL) unloadWorldStream(world);
+        else unloadLevel(&level);
+        unloadReplay(&replay);
+        return EXIT_FAILURE;
+    }
+
+    double startTime = getWallTime();
+    ReplayPlayback playback = createReplayPlayback(
+        &replay, world != NULL ? NULL : &level, world, getDefaultPlayer());
+    double elapsed = getWallTime() - startTime;
+    if (playback.snapshots == NULL)
+    {
+        fprintf(stderr, "Not enough memory to play back replay %s\n",
+                argv[0]);
+        if (world != NULL) unloadWorldStream(world);
+        else unloadLevel(&level);
+        unloadReplay(&replay);
+        return EXIT_FAILURE;
+    }
+
+    ReplaySnapshot end = seekReplay(&playback, replay.ticksSize);
+    printf("Replayed %lld ticks (%.2f s of game time) in %.3f s\n",
+           replay.ticksSize, replay.ticksSize * PHYSICS_DELTA, elapsed);
+    printf("Final player: ");
+    printRec(end.player.rect);
+    printf("Goal reached: %s\n", end.goalReached ? "yes" : "no");
+
+    if (replay.isFixed)
+        printf("Fixed point state hash: %016llx\n",
+               (unsigned long long)hashFixedPlayer(&end.fixedPlayer));
+
+    if (argc > 1)
+    {
+        long long tick = atoll(argv[1]);
+        startTime = getWallTime();
+        ReplaySnapshot seek = seekReplay(&playback, tick);
+        elapsed = getWallTime() - startTime;
+
+        printf("Player at tick %lld (found in %.3f ms): ",
+               tick, elapsed * 1000.0);
+        printRec(seek.player.rect);
+    }
+
+    unloadReplayPlayback(&playback);
+    unloadReplay(&replay);
+    if (world != NULL) unloadWorldStream(world);
+    else unloadLevel(&level);
+    return EXIT_SUCCESS;
+}
+
+// Usage: game.exe --batch [players] [ticks] [threads]
+// Steps lots of independent players through the default level on every
+// core, each following the default script from a different point.
+int runBatch(int argc, char *argv[])
+{
+    const int playersSize = argc > 0 ? atoi(argv[0]) : 10000;
+    const long long totalTicks = argc > 1 ? atoll(argv[1]) : 10000;
+    const int threadsSize = argc > 2 ? atoi(argv[2]) : 0;
+    if (playersSize <= 0) return EXIT_FAILURE;
+
+    Level level;
+    if (!loadGameLevel(&level, NULL, DEFAULT_WINDOW)) return EXIT_FAILURE;
+
+    Player *players = malloc(sizeof(Player) * playersSize);
+    PlayerInput *inputs = malloc(sizeof(PlayerInput) * playersSize);
+    bool *goalsReached = calloc(playersSize, sizeof(bool));
+    for (int i = 0; i < playersSize; i++)
+        players[i] = getDefaultPlayer();
+
+    PhysicsPool *pool = createPhysicsPool(threadsSize);
+    const int scriptSize = sizeof(DEFAULT_SCRIPT) / sizeof(DEFAULT_SCRIPT[0]);
+
+    double startTime = getWallTime();
+    long long ticksDone = 0;
+    for (int step = 0; ticksDone < totalTicks; step++)
+    {
+        int ticks = DEFAULT_SCRIPT[step % scriptSize].ticks;
+        if (ticks > totalTicks - ticksDone) ticks = totalTicks - ticksDone;
+        for (int i = 0; i < playersSize; i++)
+            inputs[i] = DEFAULT_SCRIPT[(step + i) % scriptSize].keys;
+
+        stepPlayers(pool, players, inputs, goalsReached, playersSize,
+                    &level, ticks);
+        ticksDone += ticks;
+    }
+    double elapsed = getWallTime() - startTime;
+
+    int goalsSize = 0;
+    for (int i = 0; i < playersSize; i++) goalsSize += goalsReached[i];
+
+    printf("Stepped %d players for %lld ticks on %d threads in %.3f s\n",
+           playersSize, totalTicks, pool->threadsSize, elapsed);
+    printf("Player steps per second: %.0f\n",
+           elapsed > 0 ? playersSize * (double)totalTicks / elapsed : 0.0);
+    printf("Players that reached the goal: %d\n", goalsSize);
+
+    unloadPhysicsPool(pool);
+    free(players);
+    free(inputs);
+    free(goalsReached);
+    unloadLevel(&level);
+    return EXIT_SUCCESS;
+}
+
+// Usage: game.exe --entities [actors] [ticks]
+// Steps a crowd of actors through the default level with the entity
+// systems. Three in four move like players, following the default script
+// from different points, and the rest are projectiles. Actor 0 is also
+// stepped with updatePlayer to check both give the same result.
+int runEntities(int argc, char *argv[])
+{
+    const int actorsSize = argc > 0 ? atoi(argv[0]) : 10000;
+    const long long totalTicks = argc > 1 ? atoll(argv[1]) : 10000;
+    if (actorsSize <= 0) return EXIT_FAILURE;
+
+    Level level;
+    if (!loadGameLevel(&level, NULL, DEFAULT_WINDOW)) return EXIT_FAILURE;
+
+    EntityWorld world = createEntityWorld(actorsSize);
+    Entity *actors = malloc(sizeof(Entity) * actorsSize);
+    for (int i = 0; i < actorsSize; i++)
+    {
+        if (i % 4 != 3)
+        {
+            actors[i] = spawnPlayerEntity(&world, getDefaultPlayer());
+            continue;
         }
+        actors[i] = createEntity(&world);
+        addBody(&world, actors[i], (Body){
+            .rect = {i % 1000, -200, 8, 8},
+            .velocity = {i % 2 == 0 ? 6 : -6, 1},
+        });
     }
+    Player player = getDefaultPlayer();
+
+    const int scriptSize = sizeof(DEFAULT_SCRIPT) / sizeof(DEFAULT_SCRIPT[0]);
+    int goalsSize = 0;
+    double startTime = getWallTime();
+    long long ticksDone = 0;
+    for (int step = 0; ticksDone < totalTicks; step++)
+    {
+        int ticks = DEFAULT_SCRIPT[step % scriptSize].ticks;
+        if (ticks > totalTicks - ticksDone) ticks = totalTicks - ticksDone;
+        for (int i = 0; i < actorsSize; i++)
+        {
+            Mover *mover = getMover(&world, actors[i]);
+            if (mover != NULL)
+                mover->input = DEFAULT_SCRIPT[(step + i) % scriptSize].keys;
+        }
 
-    player->velocity.x *= (isOnGround ? 0.50 : 0.40) * deltaTime;
-    player-> isMoving = false;
-
-    if (isOnGround)
-        player->boostCharge += 40 * deltaTime;
-    if (player->boostCharge > player->maxBoost)
-        player->boostCharge = player->maxBoost;
-    if (!isOnGround)
-        player->velocity.y -= GRAVITY * deltaTime;
-    if (IsKeyDown(KEY_D)) {
-        if (hasHitWall <= 0)
-            player->velocity.x += player->acceleration * deltaTime;
-        player->direction = 1;
-        player->isMoving = true;
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            goalsSize = updateEntities(&world, &level, PHYSICS_DELTA);
+            updatePlayer(&player, DEFAULT_SCRIPT[step % scriptSize].keys,
+                         &level, PHYSICS_DELTA);
+        }
+        ticksDone += ticks;
     }
-    if (IsKeyDown(KEY_A)) {
-        if (hasHitWall >= 0)
-            player->velocity.x -= player->acceleration * deltaTime;
-        player->direction = 0;
-        player->isMoving = true;
+    double elapsed = getWallTime() - startTime;
+
+    const Body *first = getBody(&world, actors[0]);
+    const bool isMatching =
+        memcmp(&first->rect, &player.rect, sizeof(Rectangle)) == 0
+        && getAnimator(&world, actors[0])->currentFrame == player.currentFrame;
+
+    printf("Stepped %d actors for %lld ticks in %.3f s\n",
+           actorsSize, totalTicks, elapsed);
+    printf("Actor steps per second: %.0f\n",
+           elapsed > 0 ? actorsSize * (double)totalTicks / elapsed : 0.0);
+    printf("Bodies touching a goal: %d\n", goalsSize);
+    printf("Actor 0 matches updatePlayer: %s\n", isMatching ? "yes" : "no");
+
+    free(actors);
+    unloadEntityWorld(&world);
+    unloadLevel(&level);
+    return isMatching ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Usage: game.exe --bake-assets
+// Writes the pixel caches the game maps at startup instead of decoding
+// and resizing PNGs. Rerun after changing any image; stale caches are
+// ignored until then.
+int runBakeAssets(void)
+{
+    int failuresSize = 0;
+    for (int i = 0; i < SHEETS_SIZE; i++)
+    {
+        const SpriteSheetAsset *sheet = &SPRITE_SHEETS[i];
+        char path[ASSET_FILE_NAME_SIZE + 32];
+        getAssetCachePath(sheet->fileName, sheet->width, sheet->height,
+                          path, sizeof(path));
+
+        if (bakeAssetCache(sheet->fileName, sheet->width, sheet->height))
+            printf("Baked %s\n", path);
+        else
+        {
+            fprintf(stderr, "Couldn't bake %s\n", path);
+            failuresSize++;
+        }
     }
-    if (IsKeyDown(KEY_W) && isOnGround)
-        player->velocity.y -= player->jumpStrength;
-    if (IsKeyDown(KEY_SPACE)
-     && !isOnGround
-     && (IsKeyDown(KEY_A) || IsKeyDown(KEY_D))
-     && player->boostCharge > 0)
+
+    return failuresSize == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Usage: game.exe --save-level file.lvl [platforms]
+// Writes the default level, plus that many random platforms scattered
+// around it, as a level file for --level. Big ones are for stress testing.
+int runSaveLevel(int argc, char *argv[])
+{
+    if (argc < 1)
     {
-        player->boostCharge -= 100 * deltaTime;
-        if (player->boostCharge < 0)
-            player->boostCharge = 0;
-        player->velocity.x *= player->boostStrength;
+        fprintf(stderr, "Usage: --save-level file.lvl [platforms]\n");
+        return EXIT_FAILURE;
     }
+    const int platformsSize = argc > 1 ? atoi(argv[1]) : 0;
+
+    Level level = createLevel(255);
+    loadDefaultLevel(&level, DEFAULT_WINDOW);
+    addStressPlatforms(&level, platformsSize);
 
-    player->rect.x += player->velocity.x;
-    player->rect.y += player->velocity.y;
+    double startTime = getWallTime();
+    bakeLevel(&level);
+    const double bakeTime = getWallTime() - startTime;
 
-    // Increment player animation frames
-    if (player->isMoving && player->timeSinceLastFrame >= (1.0 / 30.0))
+    if (!saveLevel(&level, argv[0], true))
     {
-            player->currentFrame = (player->currentFrame + 1) % 10;
-            player->timeSinceLastFrame = 0.0;
+        fprintf(stderr, "Couldn't write level %s\n", argv[0]);
+        unloadLevel(&level);
+        return EXIT_FAILURE;
     }
-    if (!player->isMoving)
+    printf("Saved %d elements to %s (baking took %.3f ms)\n",
+           level.elementsSize, argv[0], bakeTime * 1000.0);
+    unloadLevel(&level);
+
+    startTime = getWallTime();
+    if (!loadLevel(&level, argv[0]))
     {
-        player->currentFrame = 0;
-        player->timeSinceLastFrame = 0.0;
+        fprintf(stderr, "Couldn't read level %s back\n", argv[0]);
+        return EXIT_FAILURE;
     }
+    printf("Loading it back took %.3f ms\n",
+           (getWallTime() - startTime) * 1000.0);
+    unloadLevel(&level);
+
+    return EXIT_SUCCESS;
+}
+
+// Usage: game.exe --save-world file.wld [platforms]
+// Same as --save-level, but split into chunks for --world to stream in
+int runSaveWorld(int argc, char *argv[])
+{
+    if (argc < 1)
+    {
+        fprintf(stderr, "Usage: --save-world file.wld [platforms]\n");
+        return EXIT_FAILURE;
+    }
+    const int platformsSize = argc > 1 ? atoi(argv[1]) : 0;
+
+    Level level = createLevel(255);
+    loadDefaultLevel(&level, DEFAULT_WINDOW);
+    addStressPlatforms(&level, platformsSize);
+
+    const bool isSaved = saveWorld(level.elements, level.elementsSize,
+                                   WORLD_DEFAULT_CHUNK_SIZE, argv[0]);
+    if (isSaved)
+        printf("Saved %d elements to %s\n", level.elementsSize, argv[0]);
+    else
+        fprintf(stderr, "Couldn't write world %s\n", argv[0]);
+
+    unloadLevel(&level);
+    return isSaved ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 // HELPER FUNCTIONS
 
-unsigned int checkUnsignedIntBit(unsigned int item, unsigned int n)
+// Samples the keyboard once so the physics catch-up loop doesn't have to
+PlayerInput readPlayerInput(void)
 {
-    return item & (1 << n);
+    PlayerInput input = 0;
+    if (IsKeyDown(KEY_D)) input |= INPUT_RIGHT;
+    if (IsKeyDown(KEY_A)) input |= INPUT_LEFT;
+    if (IsKeyDown(KEY_W)) input |= INPUT_JUMP;
+    if (IsKeyDown(KEY_SPACE)) input |= INPUT_BOOST;
+    return input;
+}
+
+// Replaces whatever is in level with the default layout
+void loadDefaultLevel(Level *level, Window window)
+{
+    const RectangleEnv defaultElements[] = {
+        {{-10000, window.height * 2, 20000, 100}, GRAY, 1},
+        {{0, window.height / 2, window.width, 100}, GRAY, 1},
+        {{500, 0, 100, window.height}, GRAY, 1},
+        {{450, 300, 50, 10}, GRAY, 1},
+        {{200, 250, 50, 10}, GRAY, 1},
+        {{195, 205, 10, 50}, GRAY, 1},
+        {{300, 160, 50, 10}, GRAY, 1},
+        {{100, 100, 100, 10}, GRAY, 1},
+        {{450, 50, 50, 10}, GRAY, 1},
+
+        {{525, -100, 50, 50}, GREEN, 2},
+    };
+    const int defaultElementsSize =
+        sizeof(defaultElements) / sizeof(defaultElements[0]);
+
+    clearLevel(level);
+    for (int i = 0; i < defaultElementsSize; i++)
+        addLevelElement(level, defaultElements[i]);
+    bakeLevel(level);
+}
+
+// One fixed step of the game: the camera follows, then the player moves
+void tickGame(void *state, PlayerInput input)
+{
+    GameState *game = state;
+    game->previousPlayerRect = game->player.rect;
+    game->previousCameraTarget = game->camera.target;
+
+    game->camera.target = getTarget(game->camera, game->player);
+    if (isFixedPhysics)
+    {
+        if (updateFixedPlayer(&game->fixedPlayer, input, game->level))
+            game->goalReached = true;
+        applyFixedPlayer(&game->player, &game->fixedPlayer);
+    }
+    else if (updatePlayer(&game->player, input, game->level, PHYSICS_DELTA))
+        game->goalReached = true;
+    if (game->replay != NULL) recordReplayTick(game->replay, input);
+}
+
+// Back to the default player. Nothing changes the level while playing,
+// so it stays as is.
+void resetGameState(void *state)
+{
+    GameState *game = state;
+    game->player = getDefaultPlayer();
+    game->fixedPlayer = createFixedPlayer(game->player);
+    game->goalReached = false;
+    game->camera.target = getTarget(game->camera, game->player);
+    game->previousPlayerRect = game->player.rect;
+    game->previousCameraTarget = game->camera.target;
+    if (game->replay != NULL) recordReplayReset(game->replay);
+}
+
+// Scatters platformsSize random platforms around the default level. Same
+// ones every time, so runs on the same file compare. Needs baking after.
+void addStressPlatforms(Level *level, int platformsSize)
+{
+    srand(1);
+    for (int i = 0; i < platformsSize; i++)
+    {
+        const Rectangle rect = {
+            -10000 + rand() % 20000, -20000 + rand() % 21000,
+            20 + rand() % 200, 10 + rand() % 20
+        };
+        addLevelElement(level, (RectangleEnv){rect, GRAY, 1});
+    }
+}
+
+// Loads --level's file if one was given, otherwise the default layout.
+// With --world, *world streams the level in instead and level is unused.
+// Modes that can't stream pass NULL for world.
+bool loadGameLevel(Level *level, WorldStream **world, Window window)
+{
+    if (worldFileName != NULL)
+    {
+        if (world == NULL)
+        {
+            fprintf(stderr, "--world only works in game or with --headless\n");
+            return false;
+        }
+
+        const Player player = getDefaultPlayer();
+        *world = createWorldStream(worldFileName,
+                                   (Vector2){player.rect.x, player.rect.y});
+        if (*world != NULL) return true;
+        fprintf(stderr, "Couldn't read world %s\n", worldFileName);
+        return false;
+    }
+
+    if (levelFileName == NULL)
+    {
+        *level = createLevel(255);
+        loadDefaultLevel(level, window);
+        return true;
+    }
+
+    if (loadLevel(level, levelFileName)) return true;
+    fprintf(stderr, "Couldn't read level %s\n", levelFileName);
+    return false;
+}
+
+// World space rectangle the camera can see, rotation included
+Rectangle getCameraView(Camera2D camera, Window window)
+{
+    const Vector2 corners[4] = {
+        GetScreenToWorld2D((Vector2){0, 0}, camera),
+        GetScreenToWorld2D((Vector2){window.width, 0}, camera),
+        GetScreenToWorld2D((Vector2){0, window.height}, camera),
+        GetScreenToWorld2D((Vector2){window.width, window.height}, camera),
+    };
+
+    Vector2 min = corners[0], max = corners[0];
+    for (int i = 1; i < 4; i++)
+    {
+        min = (Vector2){fminf(min.x, corners[i].x), fminf(min.y, corners[i].y)};
+        max = (Vector2){fmaxf(max.x, corners[i].x), fmaxf(max.y, corners[i].y)};
+    }
+
+    return (Rectangle){min.x, min.y, max.x - min.x, max.y - min.y};
 }
 
 void printVec2(Vector2 vec) {
@@ -361,6 +1005,16 @@ void printRec(Rectangle rec)
            rec.x, rec.y, rec.width, rec.height);
 }
 
+Rectangle lerpRectangle(Rectangle start, Rectangle end, float amount)
+{
+    return (Rectangle){
+        Lerp(start.x, end.x, amount),
+        Lerp(start.y, end.y, amount),
+        Lerp(start.width, end.width, amount),
+        Lerp(start.height, end.height, amount),
+    };
+}
+
 Vector2 getTarget(Camera2D camera, Player player)
 {
     Vector2 playerCenter = {
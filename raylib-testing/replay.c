@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+static const char REPLAY_MAGIC[4] = {'R', 'P', 'L', 'Y'};
+
+static void addReplayRun(Replay *replay, ReplayRun run)
+{
+    if (replay->runsSize >= replay->runsCapacity)
+    {
+        int newCapacity = replay->runsCapacity > 0
+            ? replay->runsCapacity * 2 : 256;
+        ReplayRun *newRuns =
+            realloc(replay->runs, sizeof(ReplayRun) * newCapacity);
+        if (newRuns == NULL) return;
+        replay->runs = newRuns;
+        replay->runsCapacity = newCapacity;
+    }
+    replay->runs[replay->runsSize++] = run;
+}
+
+void recordReplayTick(Replay *replay, PlayerInput input)
+{
+    ReplayRun *last = replay->runsSize > 0
+        ? &replay->runs[replay->runsSize - 1] : NULL;
+    if (last != NULL && last->ticks > 0 && last->input == input
+     && last->ticks < 0xFFFFFFFFu)
+        last->ticks++;
+    else
+        addReplayRun(replay, (ReplayRun){input, 1});
+    replay->ticksSize++;
+}
+
+void recordReplayReset(Replay *replay)
+{
+    addReplayRun(replay, (ReplayRun){0, 0});
+}
+
+void unloadReplay(Replay *replay)
+{
+    free(replay->runs);
+    *replay = (Replay){0};
+}
+
+// FILE FORMAT
+
+static void writeU32(FILE *file, unsigned int value)
+{
+    for (int i = 0; i < 4; i++) fputc((value >> (i * 8)) & 0xFF, file);
+}
+
+static void writeU64(FILE *file, unsigned long long value)
+{
+    for (int i = 0; i < 8; i++) fputc((value >> (i * 8)) & 0xFF, file);
+}
+
+static void writeVarint(FILE *file, unsigned int value)
+{
+    while (value >= 0x80)
+    {
+        fputc((value & 0x7F) | 0x80, file);
+        value >>= 7;
+    }
+    fputc(value, file);
+}
+
+static bool readU32(FILE *file, unsigned int *value)
+{
+    *value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int c = fgetc(file);
+        if (c == EOF) return false;
+        *value |= (unsigned int)c << (i * 8);
+    }
+    return true;
+}
+
+static bool readU64(FILE *file, unsigned long long *value)
+{
+    *value = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        int c = fgetc(file);
+        if (c == EOF) return false;
+        *value |= (unsigned long long)c << (i * 8);
+    }
+    return true;
+}
+
+static bool readVarint(FILE *file, unsigned int *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        int c = fgetc(file);
+        if (c == EOF) return false;
+        *value |= (unsigned int)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool saveReplay(const Replay *replay, const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    fwrite(REPLAY_MAGIC, 1, sizeof(REPLAY_MAGIC), file);
+    writeU32(file, REPLAY_FILE_VERSION);
+    writeU32(file, (unsigned int)(1.0 / PHYSICS_DELTA + 0.5));
+    writeU64(file, replay->levelHash);
+    writeU32(file, replay->isFixed);
+    writeU64(file, replay->ticksSize);
+    writeU32(file, replay->runsSize);
+    for (int i = 0; i < replay->runsSize; i++)
+    {
+        fputc(replay->runs[i].input & 0xFF, file);
+        writeVarint(file, replay->runs[i].ticks);
+    }
+
+    bool isOk = !ferror(file);
+    return fclose(file) == 0 && isOk;
+}
+
+bool loadReplay(Replay *replay, const char *fileName)
+{
+    *replay = (Replay){0};
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    char magic[4];
+    unsigned int version, ticksPerSecond, isFixed, runsSize;
+    unsigned long long levelHash, ticksSize;
+    bool isOk = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+        && memcmp(magic, REPLAY_MAGIC, sizeof(magic)) == 0
+        && readU32(file, &version) && version == REPLAY_FILE_VERSION
+        && readU32(file, &ticksPerSecond)
+        && ticksPerSecond == (unsigned int)(1.0 / PHYSICS_DELTA + 0.5)
+        && readU64(file, &levelHash)
+        && readU32(file, &isFixed)
+        && readU64(file, &ticksSize)
+        && readU32(file, &runsSize);
+
+    for (unsigned int i = 0; isOk && i < runsSize; i++)
+    {
+        int input = fgetc(file);
+        unsigned int ticks;
+        isOk = input != EOF && readVarint(file, &ticks);
+        if (isOk) addReplayRun(replay, (ReplayRun){input, ticks});
+    }
+    fclose(file);
+
+    if (isOk)
+    {
+        long long counted = 0;
+        for (int i = 0; i < replay->runsSize; i++)
+            counted += replay->runs[i].ticks;
+        isOk = replay->runsSize == (int)runsSize
+            && counted == (long long)ticksSize;
+    }
+    if (!isOk)
+    {
+        unloadReplay(replay);
+        return false;
+    }
+
+    replay->ticksSize = ticksSize;
+    replay->levelHash = levelHash;
+    replay->isFixed = isFixed != 0;
+    return true;
+}
+
+// PLAYBACK
+
+// Applies any resets waiting at the snapshot's position in the runs
+static void skipReplayResets(const ReplayPlayback *playback,
+                             ReplaySnapshot *snapshot)
+{
+    const Replay *replay = playback->replay;
+    while (snapshot->runIndex < replay->runsSize
+        && replay->runs[snapshot->runIndex].ticks == 0)
+    {
+        snapshot->player = playback->startPlayer;
+        snapshot->fixedPlayer = createFixedPlayer(playback->startPlayer);
+        snapshot->goalReached = false;
+        snapshot->runIndex++;
+    }
+}
+
+static void stepReplay(const ReplayPlayback *playback, ReplaySnapshot *snapshot)
+{
+    const ReplayRun *run = &playback->replay->runs[snapshot->runIndex];
+    const Level *level = playback->level;
+    if (playback->world != NULL)
+    {
+        updateWorldStream(playback->world, (Vector2){
+            snapshot->player.rect.x, snapshot->player.rect.y
+        });
+        level = playback->world->level;
+    }
+
+    bool isGoalReached;
+    if (playback->replay->isFixed)
+    {
+        isGoalReached =
+            updateFixedPlayer(&snapshot->fixedPlayer, run->input, level);
+        applyFixedPlayer(&snapshot->player, &snapshot->fixedPlayer);
+    }
+    else
+        isGoalReached = updatePlayer(&snapshot->player, run->input,
+                                     level, PHYSICS_DELTA);
+    if (isGoalReached) snapshot->goalReached = true;
+
+    if (++snapshot->runOffset >= run->ticks)
+    {
+        snapshot->runIndex++;
+        snapshot->runOffset = 0;
+    }
+    skipReplayResets(playback, snapshot);
+}
+
+ReplayPlayback createReplayPlayback(const Replay *replay, const Level *level,
+                                    WorldStream *world, Player startPlayer)
+{
+    ReplayPlayback playback = {
+        .replay = replay,
+        .level = level,
+        .world = world,
+        .startPlayer = startPlayer,
+    };
+    playback.snapshotsSize = replay->ticksSize / REPLAY_SNAPSHOT_INTERVAL + 1;
+    playback.snapshots = malloc(sizeof(ReplaySnapshot) * playback.snapshotsSize);
+    if (playback.snapshots == NULL)
+    {
+        playback.snapshotsSize = 0;
+        return playback;
+    }
+
+    ReplaySnapshot snapshot = {
+        .player = startPlayer,
+        .fixedPlayer = createFixedPlayer(startPlayer),
+    };
+    skipReplayResets(&playback, &snapshot);
+    for (long long tick = 0; tick <= replay->ticksSize; tick++)
+    {
+        if (tick % REPLAY_SNAPSHOT_INTERVAL == 0)
+            playback.snapshots[tick / REPLAY_SNAPSHOT_INTERVAL] = snapshot;
+        if (tick < replay->ticksSize) stepReplay(&playback, &snapshot);
+    }
+
+    return playback;
+}
+
+void unloadReplayPlayback(ReplayPlayback *playback)
+{
+    free(playback->snapshots);
+    *playback = (ReplayPlayback){0};
+}
+
+ReplaySnapshot seekReplay(const ReplayPlayback *playback, long long tick)
+{
+    if (tick < 0) tick = 0;
+    if (tick > playback->replay->ticksSize) tick = playback->replay->ticksSize;
+
+    ReplaySnapshot snapshot =
+        playback->snapshots[tick / REPLAY_SNAPSHOT_INTERVAL];
+    for (long long i = tick % REPLAY_SNAPSHOT_INTERVAL; i > 0; i--)
+        stepReplay(playback, &snapshot);
+
+    return snapshot;
+}
@@ -0,0 +1,74 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include "fixed.h"
+#include "physics.h"
+#include "world.h"
+
+// A stretch of ticks that all had the same input. Runs with zero ticks
+// mark the game being reset back to the default player.
+typedef struct ReplayRun
+{
+    PlayerInput input;
+    unsigned int ticks;
+} ReplayRun;
+
+// Every physics tick of a session, run-length encoded, and what it was
+// played on. Set levelHash and isFixed before saving.
+typedef struct Replay
+{
+    ReplayRun *runs;
+    int runsSize;
+    int runsCapacity;
+    long long ticksSize;
+    uint64_t levelHash;       // hashLevel (or hashWorld) of the level
+    bool isFixed;             // Played with --fixed physics
+} Replay;
+
+// Player state at a tick, plus where that tick is in the runs. Fixed
+// point replays step fixedPlayer and copy it into player.
+typedef struct ReplaySnapshot
+{
+    Player player;
+    FixedPlayer fixedPlayer;
+    bool goalReached;
+    int runIndex;
+    unsigned int runOffset;
+} ReplaySnapshot;
+
+// Re-simulates a replay against a level. Snapshots are taken every
+// REPLAY_SNAPSHOT_INTERVAL ticks so any tick can be reached by stepping
+// less than one interval.
+typedef struct ReplayPlayback
+{
+    const Replay *replay;
+    const Level *level;
+    WorldStream *world;       // Streamed around the player instead, if set
+    Player startPlayer;
+    ReplaySnapshot *snapshots;
+    long long snapshotsSize;
+} ReplayPlayback;
+
+#define REPLAY_SNAPSHOT_INTERVAL 1024
+#define REPLAY_FILE_VERSION 2
+
+void recordReplayTick(Replay *replay, PlayerInput input);
+void recordReplayReset(Replay *replay);
+void unloadReplay(Replay *replay);
+
+// Files are a small header followed by one input byte and a varint tick
+// count per run. Both return false if the file couldn't be used.
+bool saveReplay(const Replay *replay, const char *fileName);
+bool loadReplay(Replay *replay, const char *fileName);
+
+// Runs the whole replay once, as fast as the CPU allows, to take snapshots.
+// Pass a blocking world (see WorldStream) or a level, with the other NULL.
+// snapshots is NULL if there wasn't memory for them.
+ReplayPlayback createReplayPlayback(const Replay *replay, const Level *level,
+                                    WorldStream *world, Player startPlayer);
+void unloadReplayPlayback(ReplayPlayback *playback);
+// State after the first `tick` ticks (clamped to the replay's length)
+ReplaySnapshot seekReplay(const ReplayPlayback *playback, long long tick);
+
+#endif // REPLAY_H
@@ -0,0 +1,60 @@
+#include <string.h>
+#include "scalarmath.h"
+#define RAYMATH_NO_SIMD
+#define RAYMATH_HEADER_ONLY
+#include "include/raymath.h"
+
+// Same loops as benchmark.c's, so only the maths differs
+
+void runScalarMatrixMultiply(const Matrix values[], Matrix results[],
+                             int valuesSize, long long opsSize)
+{
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (valuesSize - 1);
+        results[a] = MatrixMultiply(values[a], values[a ^ 1]);
+    }
+}
+
+void runScalarMatrixInvert(const Matrix values[], Matrix results[],
+                           int valuesSize, long long opsSize)
+{
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (valuesSize - 1);
+        results[a] = MatrixInvert(values[a]);
+    }
+}
+
+void runScalarMatrixTranspose(const Matrix values[], Matrix results[],
+                              int valuesSize, long long opsSize)
+{
+    for (long long i = 0; i < opsSize; i++)
+    {
+        const int a = i & (valuesSize - 1);
+        results[a] = MatrixTranspose(values[a]);
+    }
+}
+
+int countMatrixMismatches(const Matrix values[], int valuesSize,
+                          Matrix (*multiply)(Matrix, Matrix),
+                          Matrix (*invert)(Matrix),
+                          Matrix (*transpose)(Matrix))
+{
+    int mismatchesSize = 0;
+    for (int i = 0; i < valuesSize; i++)
+    {
+        const Matrix value = values[i];
+        const Matrix other = values[(i + 1) % valuesSize];
+        Matrix expected = MatrixMultiply(value, other);
+        Matrix actual = multiply(value, other);
+        mismatchesSize += memcmp(&expected, &actual, sizeof(Matrix)) != 0;
+        expected = MatrixInvert(value);
+        actual = invert(value);
+        mismatchesSize += memcmp(&expected, &actual, sizeof(Matrix)) != 0;
+        expected = MatrixTranspose(value);
+        actual = transpose(value);
+        mismatchesSize += memcmp(&expected, &actual, sizeof(Matrix)) != 0;
+    }
+    return mismatchesSize;
+}
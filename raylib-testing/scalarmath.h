@@ -0,0 +1,24 @@
+#ifndef SCALARMATH_H
+#define SCALARMATH_H
+
+#include "include/raylib.h"
+
+// The benchmark loops for raymath's matrix functions, built with its SSE
+// paths turned off (RAYMATH_NO_SIMD) so benchmark.c can compare the two.
+// Each runs opsSize ops cycling through values (valuesSize must be a power
+// of two), storing every result in the matching element of results.
+void runScalarMatrixMultiply(const Matrix values[], Matrix results[],
+                             int valuesSize, long long opsSize);
+void runScalarMatrixInvert(const Matrix values[], Matrix results[],
+                           int valuesSize, long long opsSize);
+void runScalarMatrixTranspose(const Matrix values[], Matrix results[],
+                              int valuesSize, long long opsSize);
+
+// How many of the multiply, invert and transpose results over values
+// differ from the SSE versions' in any bit
+int countMatrixMismatches(const Matrix values[], int valuesSize,
+                          Matrix (*multiply)(Matrix, Matrix),
+                          Matrix (*invert)(Matrix),
+                          Matrix (*transpose)(Matrix));
+
+#endif // SCALARMATH_H
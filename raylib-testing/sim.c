@@ -0,0 +1,114 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "platform.h"
+
+static void publishSimSnapshot(SimThread *sim, const FixedStepClock *clock)
+{
+    memcpy(sim->slots[sim->back], sim->state, sim->stateSize);
+    sim->slotInfos[sim->back] = (SimSnapshotInfo){getWallTime(), *clock};
+
+    // Hand the filled slot over and take back whichever one was waiting
+    const unsigned int previous = atomic_exchange_explicit(
+        &sim->middle, sim->back | SIM_SLOT_FRESH, memory_order_acq_rel);
+    sim->back = previous & ~SIM_SLOT_FRESH;
+}
+
+static void *runSimThread(void *argument)
+{
+    SimThread *sim = argument;
+    FixedStepClock clock = createFixedStepClock(sim->policy);
+
+    double lastTime = getWallTime();
+    while (!atomic_load_explicit(&sim->isStopping, memory_order_relaxed))
+    {
+        const double now = getWallTime();
+        const int ticks = advanceFixedStepClock(&clock, now - lastTime);
+        lastTime = now;
+
+        const PlayerInput input =
+            atomic_load_explicit(&sim->input, memory_order_relaxed);
+        const bool isResetting = atomic_exchange_explicit(
+            &sim->isResetRequested, false, memory_order_acquire);
+        if (isResetting) sim->reset(sim->state);
+        for (int tick = 0; tick < ticks; tick++)
+            sim->tick(sim->state, input);
+        if (ticks > 0 || isResetting) publishSimSnapshot(sim, &clock);
+
+        // Sleep until the next tick is due. Sleeping can overshoot, which
+        // the clock just catches up on next time round.
+        sleepSeconds((PHYSICS_DELTA - clock.timeToCatchUp) / clock.timeScale);
+    }
+
+    return NULL;
+}
+
+SimThread *createSimThread(const void *state, size_t stateSize,
+                           SimTickFunction tick, SimResetFunction reset,
+                           FixedStepPolicy policy)
+{
+    SimThread *sim = calloc(1, sizeof(SimThread));
+    sim->state = malloc(stateSize);
+    memcpy(sim->state, state, stateSize);
+    sim->stateSize = stateSize;
+    sim->tick = tick;
+    sim->reset = reset;
+    sim->policy = policy;
+
+    // Every slot starts as the initial state so the first read has
+    // something to draw
+    const SimSnapshotInfo info = {getWallTime(), createFixedStepClock(policy)};
+    for (int i = 0; i < 3; i++)
+    {
+        sim->slots[i] = malloc(stateSize);
+        memcpy(sim->slots[i], state, stateSize);
+        sim->slotInfos[i] = info;
+    }
+    sim->front = 0;
+    atomic_init(&sim->middle, 1);
+    sim->back = 2;
+
+    atomic_init(&sim->input, 0);
+    atomic_init(&sim->isResetRequested, false);
+    atomic_init(&sim->isStopping, false);
+    pthread_create(&sim->thread, NULL, runSimThread, sim);
+
+    return sim;
+}
+
+void unloadSimThread(SimThread *sim, void *state)
+{
+    atomic_store(&sim->isStopping, true);
+    pthread_join(sim->thread, NULL);
+
+    if (state != NULL) memcpy(state, sim->state, sim->stateSize);
+    for (int i = 0; i < 3; i++) free(sim->slots[i]);
+    free(sim->state);
+    free(sim);
+}
+
+void setSimInput(SimThread *sim, PlayerInput input)
+{
+    atomic_store_explicit(&sim->input, input, memory_order_relaxed);
+}
+
+void requestSimReset(SimThread *sim)
+{
+    atomic_store_explicit(&sim->isResetRequested, true, memory_order_release);
+}
+
+const void *readSimSnapshot(SimThread *sim, SimSnapshotInfo *info)
+{
+    // Only swap when the sim has published since last time, otherwise
+    // this would hand back a slot older than the one already held
+    if (atomic_load_explicit(&sim->middle, memory_order_relaxed)
+        & SIM_SLOT_FRESH)
+    {
+        const unsigned int previous = atomic_exchange_explicit(
+            &sim->middle, sim->front, memory_order_acq_rel);
+        sim->front = previous & ~SIM_SLOT_FRESH;
+    }
+
+    if (info != NULL) *info = sim->slotInfos[sim->front];
+    return sim->slots[sim->front];
+}
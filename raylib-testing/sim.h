@@ -0,0 +1,61 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include "physics.h"
+
+typedef void (*SimTickFunction)(void *state, PlayerInput input);
+typedef void (*SimResetFunction)(void *state);
+
+// When a snapshot was taken and how the clock stood at the time
+typedef struct SimSnapshotInfo
+{
+    double time;              // getWallTime() when it was published
+    FixedStepClock clock;
+} SimSnapshotInfo;
+
+// Runs fixed step ticks on its own thread, on schedule whatever the
+// renderer is doing (vsync waits included). After each batch of ticks a
+// copy of the state is published through a triple buffer: the sim writes
+// one slot, the renderer reads another, and the third is swapped between
+// them with one atomic exchange, so neither side ever waits on the other.
+typedef struct SimThread
+{
+    void *state;              // Only the sim thread touches it while running
+    size_t stateSize;
+    SimTickFunction tick;
+    SimResetFunction reset;
+    FixedStepPolicy policy;
+
+    void *slots[3];
+    SimSnapshotInfo slotInfos[3];
+    atomic_uint middle;       // Slot index, | SIM_SLOT_FRESH once published
+    unsigned int back;        // Sim thread only
+    unsigned int front;       // Render thread only
+
+    atomic_uint input;
+    atomic_bool isResetRequested;
+    atomic_bool isStopping;
+    pthread_t thread;
+} SimThread;
+
+#define SIM_SLOT_FRESH 4u
+
+// Starts ticking straight away. state is copied, and tick and reset are
+// called on the sim thread with the copy.
+SimThread *createSimThread(const void *state, size_t stateSize,
+                           SimTickFunction tick, SimResetFunction reset,
+                           FixedStepPolicy policy);
+// Stops the thread and copies the final state back into state
+void unloadSimThread(SimThread *sim, void *state);
+
+// Keys the following ticks should use, until set again
+void setSimInput(SimThread *sim, PlayerInput input);
+// Runs reset before the next tick
+void requestSimReset(SimThread *sim);
+// Newest published state (never blocks). Stays valid until the next call.
+const void *readSimSnapshot(SimThread *sim, SimSnapshotInfo *info);
+
+#endif // SIM_H
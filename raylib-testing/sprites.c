@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "sprites.h"
+
+SpriteAtlas createSpriteAtlas(int width, int height)
+{
+    Image blank = GenImageColor(width, height, BLANK);
+    SpriteAtlas atlas = {.texture = LoadTextureFromImage(blank)};
+    UnloadImage(blank);
+    return atlas;
+}
+
+int addSpriteSheet(SpriteAtlas *atlas, Image image, int columns, int rows)
+{
+    if (atlas->sheetsSize >= SPRITE_ATLAS_MAX_SHEETS) return -1;
+
+    // Start a new shelf when this row is full
+    if (atlas->shelfX + image.width > atlas->texture.width)
+    {
+        atlas->shelfX = 0;
+        atlas->shelfY += atlas->shelfHeight + SPRITE_ATLAS_PADDING;
+        atlas->shelfHeight = 0;
+    }
+    if (image.data == NULL
+     || atlas->shelfX + image.width > atlas->texture.width
+     || atlas->shelfY + image.height > atlas->texture.height)
+    {
+        fprintf(stderr, "Sprite sheet %dx%d doesn't fit in the atlas\n",
+                image.width, image.height);
+        return -1;
+    }
+
+    const Rectangle placed = {
+        atlas->shelfX, atlas->shelfY, image.width, image.height
+    };
+    // The atlas is RGBA, so match it before uploading just this rectangle.
+    // Baked caches are RGBA already and go up straight from their mapping.
+    if (image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+        UpdateTextureRec(atlas->texture, placed, image.data);
+    else
+    {
+        Image pixels = ImageCopy(image);
+        ImageFormat(&pixels, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        UpdateTextureRec(atlas->texture, placed, pixels.data);
+        UnloadImage(pixels);
+    }
+    atlas->shelfX += image.width + SPRITE_ATLAS_PADDING;
+    if (image.height > atlas->shelfHeight) atlas->shelfHeight = image.height;
+
+    // Work out every frame's source rectangle once, up front
+    SpriteSheet sheet = {
+        .frames = malloc(sizeof(Rectangle) * columns * rows),
+        .columns = columns,
+        .rows = rows,
+        .frameWidth = image.width / columns,
+        .frameHeight = image.height / rows,
+    };
+    for (int row = 0; row < rows; row++)
+        for (int column = 0; column < columns; column++)
+            sheet.frames[row * columns + column] = (Rectangle){
+                placed.x + column * sheet.frameWidth,
+                placed.y + row * sheet.frameHeight,
+                sheet.frameWidth,
+                sheet.frameHeight
+            };
+
+    atlas->sheets[atlas->sheetsSize] = sheet;
+    return atlas->sheetsSize++;
+}
+
+void unloadSpriteAtlas(SpriteAtlas *atlas)
+{
+    if (atlas->texture.id != 0) UnloadTexture(atlas->texture);
+    for (int i = 0; i < atlas->sheetsSize; i++)
+        free(atlas->sheets[i].frames);
+    *atlas = (SpriteAtlas){0};
+}
+
+Rectangle getSpriteFrame(const SpriteAtlas *atlas, int sheet,
+                         int column, int row)
+{
+    // Sheets that failed to load just draw nothing
+    if (sheet < 0 || sheet >= atlas->sheetsSize) return (Rectangle){0};
+
+    const SpriteSheet *spriteSheet = &atlas->sheets[sheet];
+    return spriteSheet->frames[row * spriteSheet->columns + column];
+}
+
+void addSprite(SpriteBatch *batch, Rectangle frame, Vector2 position,
+               bool isFlipped, Color tint)
+{
+    if (batch->spritesSize >= batch->spritesCapacity)
+    {
+        int newCapacity = batch->spritesCapacity > 0
+            ? batch->spritesCapacity * 2 : 64;
+        Sprite *newSprites =
+            realloc(batch->sprites, sizeof(Sprite) * newCapacity);
+        if (newSprites == NULL) return;
+        batch->sprites = newSprites;
+        batch->spritesCapacity = newCapacity;
+    }
+
+    Rectangle source = frame;
+    if (isFlipped) source.width = -source.width;
+    batch->sprites[batch->spritesSize++] = (Sprite){
+        source,
+        (Rectangle){position.x, position.y, frame.width, frame.height},
+        tint
+    };
+}
+
+void drawSpriteBatch(SpriteBatch *batch, const SpriteAtlas *atlas)
+{
+    // Same texture every time, so raylib keeps it all in one draw call
+    for (int i = 0; i < batch->spritesSize; i++)
+        DrawTexturePro(atlas->texture, batch->sprites[i].source,
+                       batch->sprites[i].dest, (Vector2){0, 0}, 0,
+                       batch->sprites[i].tint);
+    batch->spritesSize = 0;
+}
+
+void unloadSpriteBatch(SpriteBatch *batch)
+{
+    free(batch->sprites);
+    *batch = (SpriteBatch){0};
+}
@@ -0,0 +1,65 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include "include/raylib.h"
+
+// A grid of equally sized frames somewhere in an atlas. frames holds each
+// frame's source rectangle in atlas pixels, row by row.
+typedef struct SpriteSheet
+{
+    Rectangle *frames;
+    int columns;
+    int rows;
+    int frameWidth;
+    int frameHeight;
+} SpriteSheet;
+
+#define SPRITE_ATLAS_MAX_SHEETS 32
+#define SPRITE_ATLAS_PADDING 2
+
+// Every sprite sheet packed into one texture so sprites never have to
+// switch textures between draws. Sheets go on shelves (rows filled left to
+// right) and only their own rectangle of the texture gets uploaded, so
+// sheets can keep arriving while the game runs.
+typedef struct SpriteAtlas
+{
+    Texture2D texture;
+    SpriteSheet sheets[SPRITE_ATLAS_MAX_SHEETS];
+    int sheetsSize;
+    int shelfX;
+    int shelfY;
+    int shelfHeight;
+} SpriteAtlas;
+
+typedef struct Sprite
+{
+    Rectangle source;         // Negative width flips horizontally
+    Rectangle dest;
+    Color tint;
+} Sprite;
+
+// Sprites queued for one layer, drawn together with a single texture
+typedef struct SpriteBatch
+{
+    Sprite *sprites;
+    int spritesSize;
+    int spritesCapacity;
+} SpriteBatch;
+
+// Needs a window (GL context), since the blank texture is uploaded here
+SpriteAtlas createSpriteAtlas(int width, int height);
+// Uploads image into the atlas and returns the new sheet's index, or -1 if
+// it doesn't fit. Main thread only. The caller still owns image.
+int addSpriteSheet(SpriteAtlas *atlas, Image image, int columns, int rows);
+void unloadSpriteAtlas(SpriteAtlas *atlas);
+// Empty rectangle if sheet is -1 (a sheet that didn't fit)
+Rectangle getSpriteFrame(const SpriteAtlas *atlas, int sheet,
+                         int column, int row);
+
+void addSprite(SpriteBatch *batch, Rectangle frame, Vector2 position,
+               bool isFlipped, Color tint);
+// Draws every queued sprite in order and empties the batch
+void drawSpriteBatch(SpriteBatch *batch, const SpriteAtlas *atlas);
+void unloadSpriteBatch(SpriteBatch *batch);
+
+#endif // SPRITES_H
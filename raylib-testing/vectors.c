@@ -0,0 +1,239 @@
+#include "vectors.h"
+// Header only so the leftover elements use raymath's own code
+#define RAYMATH_HEADER_ONLY
+#include "include/raymath.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+#elif defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
+// Vector2 arrays are just x, y, x, y... floats, so these work on as many
+// floats as fit in a register whatever lines up with which point
+#if defined(__AVX__)
+    typedef __m256 Lanes;
+    #define LANES_SIZE 8
+    #define loadLanes(p) _mm256_loadu_ps(p)
+    #define storeLanes(p, v) _mm256_storeu_ps(p, v)
+    #define setLanes(x) _mm256_set1_ps(x)
+    #define setPairLanes(a, b) _mm256_setr_ps(a, b, a, b, a, b, a, b)
+    #define addLanes(a, b) _mm256_add_ps(a, b)
+    #define subLanes(a, b) _mm256_sub_ps(a, b)
+    #define mulLanes(a, b) _mm256_mul_ps(a, b)
+    #define divLanes(a, b) _mm256_div_ps(a, b)
+    #define sqrtLanes(a) _mm256_sqrt_ps(a)
+    // 1 wherever a is 0, 0 elsewhere
+    #define zeroToOneLanes(a) _mm256_and_ps( \
+        _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_EQ_OQ), setLanes(1.0f))
+    // x0 y0 x1 y1 -> y0 x0 y1 x1
+    #define swapPairLanes(a) _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1))
+    // x0 y0 x1 y1 -> x0 x0 x1 x1, and -> y0 y0 y1 y1
+    #define pairFirstLanes(a) _mm256_moveldup_ps(a)
+    #define pairSecondLanes(a) _mm256_movehdup_ps(a)
+#elif defined(__SSE__)
+    typedef __m128 Lanes;
+    #define LANES_SIZE 4
+    #define loadLanes(p) _mm_loadu_ps(p)
+    #define storeLanes(p, v) _mm_storeu_ps(p, v)
+    #define setLanes(x) _mm_set1_ps(x)
+    #define setPairLanes(a, b) _mm_setr_ps(a, b, a, b)
+    #define addLanes(a, b) _mm_add_ps(a, b)
+    #define subLanes(a, b) _mm_sub_ps(a, b)
+    #define mulLanes(a, b) _mm_mul_ps(a, b)
+    #define divLanes(a, b) _mm_div_ps(a, b)
+    #define sqrtLanes(a) _mm_sqrt_ps(a)
+    #define zeroToOneLanes(a) \
+        _mm_and_ps(_mm_cmpeq_ps(a, _mm_setzero_ps()), setLanes(1.0f))
+    #define swapPairLanes(a) _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1))
+    #define pairFirstLanes(a) _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0))
+    #define pairSecondLanes(a) _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1))
+#endif
+
+// Points handled per register, 0 without SIMD so the loops get skipped
+#if defined(LANES_SIZE)
+    #define VECTOR2S_PER_LANES (LANES_SIZE / 2)
+#else
+    #define VECTOR2S_PER_LANES 0
+#endif
+
+void addVector2s(Vector2 out[], const Vector2 a[], const Vector2 b[],
+                 int size)
+{
+    int i = 0;
+#if defined(LANES_SIZE)
+    for (; i + VECTOR2S_PER_LANES <= size; i += VECTOR2S_PER_LANES)
+        storeLanes(&out[i].x, addLanes(loadLanes(&a[i].x),
+                                       loadLanes(&b[i].x)));
+#endif
+    for (; i < size; i++) out[i] = Vector2Add(a[i], b[i]);
+}
+
+void scaleVector2s(Vector2 out[], const Vector2 v[], float scale, int size)
+{
+    int i = 0;
+#if defined(LANES_SIZE)
+    const Lanes scales = setLanes(scale);
+    for (; i + VECTOR2S_PER_LANES <= size; i += VECTOR2S_PER_LANES)
+        storeLanes(&out[i].x, mulLanes(loadLanes(&v[i].x), scales));
+#endif
+    for (; i < size; i++) out[i] = Vector2Scale(v[i], scale);
+}
+
+void lerpVector2s(Vector2 out[], const Vector2 from[], const Vector2 to[],
+                  float amount, int size)
+{
+    int i = 0;
+#if defined(LANES_SIZE)
+    const Lanes amounts = setLanes(amount);
+    for (; i + VECTOR2S_PER_LANES <= size; i += VECTOR2S_PER_LANES)
+    {
+        const Lanes start = loadLanes(&from[i].x);
+        const Lanes end = loadLanes(&to[i].x);
+        storeLanes(&out[i].x,
+                   addLanes(start, mulLanes(amounts, subLanes(end, start))));
+    }
+#endif
+    for (; i < size; i++) out[i] = Vector2Lerp(from[i], to[i], amount);
+}
+
+void normalizeVector2s(Vector2 out[], const Vector2 v[], int size)
+{
+    int i = 0;
+#if defined(LANES_SIZE)
+    const Lanes ones = setLanes(1.0f);
+    for (; i + VECTOR2S_PER_LANES <= size; i += VECTOR2S_PER_LANES)
+    {
+        const Lanes values = loadLanes(&v[i].x);
+        // x*x + y*y lands in both of a point's lanes
+        const Lanes squares = mulLanes(values, values);
+        Lanes lengths = sqrtLanes(addLanes(squares, swapPairLanes(squares)));
+        lengths = addLanes(lengths, zeroToOneLanes(lengths));
+        storeLanes(&out[i].x, mulLanes(values, divLanes(ones, lengths)));
+    }
+#endif
+    for (; i < size; i++)
+    {
+        float length = Vector2Length(v[i]);
+        if (length == 0.0f) length = 1.0f;
+        out[i] = Vector2Scale(v[i], 1 / length);
+    }
+}
+
+void transformVector2s(Vector2 out[], const Vector2 v[], Matrix mat,
+                       int size)
+{
+    int i = 0;
+#if defined(LANES_SIZE)
+    const Lanes xColumn = setPairLanes(mat.m0, mat.m1);
+    const Lanes yColumn = setPairLanes(mat.m4, mat.m5);
+    const Lanes translation = setPairLanes(mat.m12, mat.m13);
+    for (; i + VECTOR2S_PER_LANES <= size; i += VECTOR2S_PER_LANES)
+    {
+        const Lanes values = loadLanes(&v[i].x);
+        storeLanes(&out[i].x, addLanes(
+            addLanes(mulLanes(xColumn, pairFirstLanes(values)),
+                     mulLanes(yColumn, pairSecondLanes(values))),
+            translation));
+    }
+#endif
+    for (; i < size; i++)
+    {
+        const float x = v[i].x;
+        const float y = v[i].y;
+        out[i] = (Vector2){mat.m0*x + mat.m4*y + mat.m12,
+                           mat.m1*x + mat.m5*y + mat.m13};
+    }
+}
+
+// Vector3s don't line up with registers, so four at a time get shuffled
+// from x y z x | y z x y | z x y z into one register per axis and back.
+// This is SSE even on AVX builds, where the shuffles would cost more than
+// the wider maths saves.
+#if defined(__SSE__)
+static void loadVector3s(const Vector3 v[], __m128 *x, __m128 *y, __m128 *z)
+{
+    const __m128 a = _mm_loadu_ps(&v[0].x);
+    const __m128 b = _mm_loadu_ps(&v[1].y);
+    const __m128 c = _mm_loadu_ps(&v[2].z);
+
+    *x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+                        _MM_SHUFFLE(2, 0, 3, 0));
+    *y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                        _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+    *z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                        _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                        _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+static void storeVector3s(Vector3 out[], __m128 x, __m128 y, __m128 z)
+{
+    const __m128 a = _mm_shuffle_ps(
+        _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+        _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 b = _mm_shuffle_ps(
+        _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+        _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 c = _mm_shuffle_ps(
+        _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+        _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)),
+        _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storeu_ps(&out[0].x, a);
+    _mm_storeu_ps(&out[1].y, b);
+    _mm_storeu_ps(&out[2].z, c);
+}
+#endif
+
+void normalizeVector3s(Vector3 out[], const Vector3 v[], int size)
+{
+    int i = 0;
+#if defined(__SSE__)
+    const __m128 ones = _mm_set1_ps(1.0f);
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 x, y, z;
+        loadVector3s(&v[i], &x, &y, &z);
+        __m128 lengths = _mm_sqrt_ps(_mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        lengths = _mm_add_ps(lengths, _mm_and_ps(
+            _mm_cmpeq_ps(lengths, _mm_setzero_ps()), ones));
+        const __m128 inverses = _mm_div_ps(ones, lengths);
+        storeVector3s(&out[i], _mm_mul_ps(x, inverses),
+                      _mm_mul_ps(y, inverses), _mm_mul_ps(z, inverses));
+    }
+#endif
+    for (; i < size; i++) out[i] = Vector3Normalize(v[i]);
+}
+
+void transformVector3s(Vector3 out[], const Vector3 v[], Matrix mat,
+                       int size)
+{
+    int i = 0;
+#if defined(__SSE__)
+    const float rows[3][4] = {
+        {mat.m0, mat.m4, mat.m8, mat.m12},
+        {mat.m1, mat.m5, mat.m9, mat.m13},
+        {mat.m2, mat.m6, mat.m10, mat.m14},
+    };
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 x, y, z;
+        loadVector3s(&v[i], &x, &y, &z);
+        __m128 results[3];
+        for (int row = 0; row < 3; row++)
+        {
+            const float *m = rows[row];
+            results[row] = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(m[0]), x),
+                _mm_mul_ps(_mm_set1_ps(m[1]), y)),
+                _mm_mul_ps(_mm_set1_ps(m[2]), z)),
+                _mm_set1_ps(m[3]));
+        }
+        storeVector3s(&out[i], results[0], results[1], results[2]);
+    }
+#endif
+    for (; i < size; i++) out[i] = Vector3Transform(v[i], mat);
+}
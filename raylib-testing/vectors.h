@@ -0,0 +1,36 @@
+#ifndef VECTORS_H
+#define VECTORS_H
+
+#include "include/raylib.h"
+
+// Array versions of raymath's vector functions, for moving lots of points
+// at once. They run 8 (AVX) or 4 (SSE) floats at a time, and fall back to
+// plain loops when neither is available.
+//
+// Each does the same operations in the same order as its raymath
+// counterpart, so results match it bit for bit (unless the compiler fuses
+// multiplies and adds differently, e.g. with -mfma). out may be the same
+// array as an input, but mustn't partly overlap one.
+
+// Vector2Add
+void addVector2s(Vector2 out[], const Vector2 a[], const Vector2 b[],
+                 int size);
+// Vector2Scale
+void scaleVector2s(Vector2 out[], const Vector2 v[], float scale, int size);
+// Vector2Lerp
+void lerpVector2s(Vector2 out[], const Vector2 from[], const Vector2 to[],
+                  float amount, int size);
+// Vector2Normalize, except zero vectors stay zero (like Vector3Normalize)
+// rather than turning into NaN
+void normalizeVector2s(Vector2 out[], const Vector2 v[], int size);
+// mat applied to (x, y, 0, 1)
+void transformVector2s(Vector2 out[], const Vector2 v[], Matrix mat,
+                       int size);
+
+// Vector3Normalize
+void normalizeVector3s(Vector3 out[], const Vector3 v[], int size);
+// Vector3Transform
+void transformVector3s(Vector3 out[], const Vector3 v[], Matrix mat,
+                       int size);
+
+#endif // VECTORS_H
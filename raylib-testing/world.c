@@ -0,0 +1,347 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "world.h"
+#include "platform.h"
+
+static const char WORLD_FILE_MAGIC[4] = {'W', 'R', 'L', 'D'};
+
+// An element waiting to be written, and the chunk it belongs to
+typedef struct ChunkedElement
+{
+    int chunkX;
+    int chunkY;
+    int index;
+} ChunkedElement;
+
+// Row by row, then left to right, keeping level order within a chunk
+static int compareChunkedElements(const void *a, const void *b)
+{
+    const ChunkedElement *x = a, *y = b;
+    if (x->chunkY != y->chunkY)
+        return (x->chunkY > y->chunkY) - (x->chunkY < y->chunkY);
+    if (x->chunkX != y->chunkX)
+        return (x->chunkX > y->chunkX) - (x->chunkX < y->chunkX);
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+bool saveWorld(const RectangleEnv elements[], int elementsSize,
+               float chunkSize, const char *fileName)
+{
+    // Anything wider or taller than a chunk is kept loaded all the time,
+    // so every other element reaches at most one chunk past its own
+    const int capacity = elementsSize > 0 ? elementsSize : 1;
+    ChunkedElement *chunked = malloc(sizeof(ChunkedElement) * capacity);
+    WorldElement *globals = malloc(sizeof(WorldElement) * capacity);
+    int chunkedSize = 0, globalsSize = 0;
+    for (int i = 0; i < elementsSize; i++)
+    {
+        const Rectangle rect = elements[i].rect;
+        if (rect.width > chunkSize || rect.height > chunkSize)
+            globals[globalsSize++] = (WorldElement){elements[i], i, 0};
+        else
+            chunked[chunkedSize++] = (ChunkedElement){
+                (int)floorf(rect.x / chunkSize),
+                (int)floorf(rect.y / chunkSize),
+                i
+            };
+    }
+    qsort(chunked, chunkedSize, sizeof(ChunkedElement),
+          compareChunkedElements);
+
+    // Chunk table, with each chunk's elements after the global ones
+    WorldChunk *chunks = malloc(sizeof(WorldChunk) * capacity);
+    int chunksSize = 0;
+    for (int i = 0; i < chunkedSize; i++)
+    {
+        if (chunksSize == 0
+         || chunks[chunksSize - 1].chunkX != chunked[i].chunkX
+         || chunks[chunksSize - 1].chunkY != chunked[i].chunkY)
+            chunks[chunksSize++] = (WorldChunk){
+                .chunkX = chunked[i].chunkX, .chunkY = chunked[i].chunkY
+            };
+        chunks[chunksSize - 1].elementsSize++;
+    }
+
+    WorldFileHeader header = {
+        .version = WORLD_FILE_VERSION,
+        .chunkSize = chunkSize,
+        .chunksSize = chunksSize,
+        .globalElementsSize = globalsSize,
+        .globalOffset = sizeof(WorldFileHeader)
+                      + sizeof(WorldChunk) * (uint64_t)chunksSize,
+    };
+    memcpy(header.magic, WORLD_FILE_MAGIC, sizeof(header.magic));
+    uint64_t offset = header.globalOffset
+                    + sizeof(WorldElement) * (uint64_t)globalsSize;
+    for (int i = 0; i < chunksSize; i++)
+    {
+        chunks[i].offset = offset;
+        offset += sizeof(WorldElement) * (uint64_t)chunks[i].elementsSize;
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    bool isOk = file != NULL
+        && fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(chunks, sizeof(WorldChunk), chunksSize, file)
+           == (size_t)chunksSize
+        && fwrite(globals, sizeof(WorldElement), globalsSize, file)
+           == (size_t)globalsSize;
+    for (int i = 0; isOk && i < chunkedSize; i++)
+    {
+        const int index = chunked[i].index;
+        const WorldElement element = {elements[index], index, 0};
+        isOk = fwrite(&element, sizeof(WorldElement), 1, file) == 1;
+    }
+    if (file != NULL && fclose(file) != 0) isOk = false;
+
+    free(chunked);
+    free(globals);
+    free(chunks);
+    return isOk;
+}
+
+// Index of the first chunk at or after (chunkX, chunkY) in table order
+static int findWorldChunk(const WorldStream *stream, int chunkX, int chunkY)
+{
+    int low = 0, high = stream->header->chunksSize;
+    while (low < high)
+    {
+        const int middle = low + (high - low) / 2;
+        const WorldChunk *chunk = &stream->chunks[middle];
+        if (chunk->chunkY < chunkY
+         || (chunk->chunkY == chunkY && chunk->chunkX < chunkX))
+            low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+// Gathers pointers to elementsSize elements stored at offset
+static int gatherWorldElements(const WorldElement **gathered,
+                               const WorldStream *stream, uint64_t offset,
+                               uint32_t elementsSize)
+{
+    const WorldElement *elements =
+        (const WorldElement *)(stream->mapping + offset);
+    for (uint32_t i = 0; i < elementsSize; i++) gathered[i] = &elements[i];
+    return elementsSize;
+}
+
+static int compareWorldElements(const void *a, const void *b)
+{
+    const uint32_t x = (*(const WorldElement *const *)a)->index;
+    const uint32_t y = (*(const WorldElement *const *)b)->index;
+    return (x > y) - (x < y);
+}
+
+// Bakes the global elements plus every chunk within WORLD_STREAM_RADIUS
+// of (centerX, centerY), in the order they had in the saved level. Only
+// reads the mapping, so workers can run it.
+static Level *buildWorldLevel(const WorldStream *stream,
+                              int centerX, int centerY)
+{
+    // Each chunk (and the globals) is stored in level order, but they
+    // interleave, so everything loaded gets sorted back together
+    int first[2 * WORLD_STREAM_RADIUS + 1];
+    int last[2 * WORLD_STREAM_RADIUS + 1];
+    int elementsSize = stream->header->globalElementsSize;
+    for (int row = 0; row <= 2 * WORLD_STREAM_RADIUS; row++)
+    {
+        const int y = centerY - WORLD_STREAM_RADIUS + row;
+        first[row] = findWorldChunk(stream, centerX - WORLD_STREAM_RADIUS, y);
+        last[row] = first[row];
+        while (last[row] < (int)stream->header->chunksSize
+            && stream->chunks[last[row]].chunkY == y
+            && stream->chunks[last[row]].chunkX
+               <= centerX + WORLD_STREAM_RADIUS)
+            elementsSize += stream->chunks[last[row]++].elementsSize;
+    }
+
+    const WorldElement **gathered =
+        malloc(sizeof(WorldElement *) * (elementsSize > 0 ? elementsSize : 1));
+    int gatheredSize = gatherWorldElements(gathered, stream,
+        stream->header->globalOffset, stream->header->globalElementsSize);
+    for (int row = 0; row <= 2 * WORLD_STREAM_RADIUS; row++)
+        for (int i = first[row]; i < last[row]; i++)
+            gatheredSize += gatherWorldElements(gathered + gatheredSize, stream,
+                stream->chunks[i].offset, stream->chunks[i].elementsSize);
+    qsort(gathered, gatheredSize, sizeof(WorldElement *),
+          compareWorldElements);
+
+    Level *level = malloc(sizeof(Level));
+    *level = createLevel(gatheredSize + 256);
+    for (int i = 0; i < gatheredSize; i++)
+        addLevelElement(level, gathered[i]->element);
+    free(gathered);
+
+    bakeLevel(level);
+    return level;
+}
+
+static void freeWorldLevel(Level *level)
+{
+    if (level == NULL) return;
+    unloadLevel(level);
+    free(level);
+}
+
+static void *runWorldWorker(void *argument)
+{
+    WorldStream *stream = argument;
+
+    pthread_mutex_lock(&stream->mutex);
+    while (true)
+    {
+        while (!stream->hasJob && !stream->isStopping)
+            pthread_cond_wait(&stream->workReady, &stream->mutex);
+        if (stream->isStopping) break;
+
+        const int centerX = stream->jobCenterX, centerY = stream->jobCenterY;
+        stream->hasJob = false;
+        pthread_mutex_unlock(&stream->mutex);
+
+        Level *level = buildWorldLevel(stream, centerX, centerY);
+
+        pthread_mutex_lock(&stream->mutex);
+        freeWorldLevel(stream->built);
+        stream->built = level;
+    }
+    pthread_mutex_unlock(&stream->mutex);
+
+    return NULL;
+}
+
+static bool isWorldFileValid(const unsigned char *data, size_t size)
+{
+    const WorldFileHeader *header = (const WorldFileHeader *)data;
+    if (size < sizeof(WorldFileHeader)
+     || memcmp(header->magic, WORLD_FILE_MAGIC, sizeof(header->magic)) != 0
+     || header->version != WORLD_FILE_VERSION
+     || !(header->chunkSize > 0)) return false;
+
+    const uint64_t tableEnd = sizeof(WorldFileHeader)
+        + sizeof(WorldChunk) * (uint64_t)header->chunksSize;
+    if (tableEnd > size) return false;
+    if (header->globalOffset > size
+     || (size - header->globalOffset) / sizeof(WorldElement)
+        < header->globalElementsSize) return false;
+
+    const WorldChunk *chunks =
+        (const WorldChunk *)(data + sizeof(WorldFileHeader));
+    for (uint32_t i = 0; i < header->chunksSize; i++)
+        if (chunks[i].offset > size
+         || (size - chunks[i].offset) / sizeof(WorldElement)
+            < chunks[i].elementsSize) return false;
+
+    return true;
+}
+
+WorldStream *createWorldStream(const char *fileName, Vector2 center)
+{
+    size_t size;
+    const unsigned char *data = mapFile(fileName, &size);
+    if (data == NULL) return NULL;
+    if (!isWorldFileValid(data, size))
+    {
+        unmapFile(data, size);
+        return NULL;
+    }
+
+    WorldStream *stream = calloc(1, sizeof(WorldStream));
+    stream->mapping = data;
+    stream->mappingSize = size;
+    stream->header = (const WorldFileHeader *)data;
+    stream->chunks = (const WorldChunk *)(data + sizeof(WorldFileHeader));
+    stream->centerX = (int)floorf(center.x / stream->header->chunkSize);
+    stream->centerY = (int)floorf(center.y / stream->header->chunkSize);
+    stream->level = buildWorldLevel(stream, stream->centerX, stream->centerY);
+
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->workReady, NULL);
+    pthread_create(&stream->thread, NULL, runWorldWorker, stream);
+
+    return stream;
+}
+
+void unloadWorldStream(WorldStream *stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    stream->isStopping = true;
+    pthread_cond_signal(&stream->workReady);
+    pthread_mutex_unlock(&stream->mutex);
+    pthread_join(stream->thread, NULL);
+
+    freeWorldLevel(stream->level);
+    freeWorldLevel(stream->built);
+    pthread_mutex_destroy(&stream->mutex);
+    pthread_cond_destroy(&stream->workReady);
+    unmapFile(stream->mapping, stream->mappingSize);
+    free(stream);
+}
+
+bool updateWorldStream(WorldStream *stream, Vector2 center)
+{
+    bool isChanged = false;
+    if (stream->isBuilding)
+    {
+        pthread_mutex_lock(&stream->mutex);
+        Level *built = stream->built;
+        stream->built = NULL;
+        pthread_mutex_unlock(&stream->mutex);
+
+        if (built != NULL)
+        {
+            freeWorldLevel(stream->level);
+            stream->level = built;
+            stream->isBuilding = false;
+            isChanged = true;
+        }
+    }
+
+    // Waiting for the camera to get more than a chunk away means crossing
+    // back and forth over a chunk edge never rebuilds anything
+    const int chunkX = (int)floorf(center.x / stream->header->chunkSize);
+    const int chunkY = (int)floorf(center.y / stream->header->chunkSize);
+    if (!stream->isBuilding
+     && (abs(chunkX - stream->centerX) > 1
+         || abs(chunkY - stream->centerY) > 1))
+    {
+        stream->centerX = chunkX;
+        stream->centerY = chunkY;
+        if (stream->isBlocking)
+        {
+            freeWorldLevel(stream->level);
+            stream->level = buildWorldLevel(stream, chunkX, chunkY);
+            return true;
+        }
+        stream->isBuilding = true;
+
+        pthread_mutex_lock(&stream->mutex);
+        stream->jobCenterX = chunkX;
+        stream->jobCenterY = chunkY;
+        stream->hasJob = true;
+        pthread_cond_signal(&stream->workReady);
+        pthread_mutex_unlock(&stream->mutex);
+    }
+
+    return isChanged;
+}
+
+uint64_t hashWorld(const WorldStream *stream)
+{
+    uint64_t hash = 0;
+    const WorldElement *globals =
+        (const WorldElement *)(stream->mapping + stream->header->globalOffset);
+    for (uint32_t i = 0; i < stream->header->globalElementsSize; i++)
+        hash += hashLevelElement(globals[i].element, globals[i].index);
+    for (uint32_t c = 0; c < stream->header->chunksSize; c++)
+    {
+        const WorldElement *elements = (const WorldElement *)
+            (stream->mapping + stream->chunks[c].offset);
+        for (uint32_t i = 0; i < stream->chunks[c].elementsSize; i++)
+            hash += hashLevelElement(elements[i].element, elements[i].index);
+    }
+    return hash;
+}
@@ -0,0 +1,94 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/raylib.h"
+#include "level.h"
+
+// Start of a world file. The chunk table follows it, sorted by chunkY then
+// chunkX, and each chunk's elements are stored wherever its entry says, as
+// WorldElements in level order.
+typedef struct WorldFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    float chunkSize;
+    uint32_t chunksSize;
+    uint32_t globalElementsSize;
+    uint32_t reserved;
+    uint64_t globalOffset;    // Elements too big for one chunk, always loaded
+} WorldFileHeader;
+
+typedef struct WorldChunk
+{
+    int32_t chunkX;
+    int32_t chunkY;
+    uint32_t elementsSize;
+    uint32_t reserved;
+    uint64_t offset;
+} WorldChunk;
+
+// An element and where it was in the level the world was saved from.
+// Loaded chunks are baked back in that order, so collisions resolve the same
+// way they would in the flat level.
+typedef struct WorldElement
+{
+    RectangleEnv element;
+    uint32_t index;
+    uint32_t reserved;
+} WorldElement;
+
+#define WORLD_FILE_VERSION 2
+#define WORLD_DEFAULT_CHUNK_SIZE 1024.0f
+// Chunks this far (in chunks) from the centre chunk stay loaded. The
+// centre only moves once the camera is more than one chunk away from it.
+#define WORLD_STREAM_RADIUS 2
+
+// A world file too big to keep baked all at once, split into square
+// chunks. Elements belong to the chunk holding their top left corner.
+// Only the chunks around the camera are baked into `level`, which a
+// worker thread rebuilds as the camera moves and updateWorldStream swaps
+// in, so memory and per-frame cost depend on the radius, not the world.
+typedef struct WorldStream
+{
+    const unsigned char *mapping;
+    size_t mappingSize;
+    const WorldFileHeader *header;
+    const WorldChunk *chunks;
+    Level *level;             // What physics and drawing should use
+    int centerX;              // Chunk the newest level (or job) is built around
+    int centerY;
+    bool isBuilding;          // Main thread only: a job is queued or running
+    // Rebuild on the calling thread instead, so the level always covers the
+    // camera and results don't depend on thread timing (for headless runs)
+    bool isBlocking;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t workReady;
+    bool isStopping;
+    bool hasJob;
+    int jobCenterX;
+    int jobCenterY;
+    Level *built;             // Finished level waiting to be swapped in
+} WorldStream;
+
+// Splits elements into chunks and writes them as a world file
+bool saveWorld(const RectangleEnv elements[], int elementsSize,
+               float chunkSize, const char *fileName);
+
+// Maps a world file and bakes the chunks around center before returning,
+// so there's something to stand on straight away. NULL if it can't be read.
+WorldStream *createWorldStream(const char *fileName, Vector2 center);
+void unloadWorldStream(WorldStream *stream);
+// Call once per frame (or tick) from the thread that uses stream->level.
+// Queues a rebuild when center has moved far enough (or does it there and
+// then if isBlocking) and swaps in finished ones. Returns true if
+// stream->level changed, in which case the old one is gone.
+bool updateWorldStream(WorldStream *stream, Vector2 center);
+// hashLevel of the level the world was saved from, loaded or not
+uint64_t hashWorld(const WorldStream *stream);
+
+#endif // WORLD_H